@@ -1,7 +1,9 @@
 #include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
@@ -22,12 +24,49 @@ struct Args {
     int q = 1;
     int iters = 3;
     int runs = 1;
-    double peak_tflops = 0.0;
-    std::string hip_cmd = "./build/hip_cholesky --n {n} --iters {iters}";
-    std::string roc_cmd = "./build/roc_cholesky --n {n} --iters {iters}";
+    int bandwidth = -1;
+    int threads = 0;
+    bool gemm = false;
+    bool gp = false;
+    bool pivoted = false;
+    bool server = false;
+    bool calibrate = true;
+    bool recalibrate = false;
+    std::string hip_cmd = "./build/hip_cholesky --n {n} --bandwidth {bandwidth} --iters {iters}";
+    std::string roc_cmd = "./build/roc_cholesky --n {n} --bandwidth {bandwidth} --iters {iters}";
     std::string scalapack_cmd =
         "mpirun -np {np} ./build/scalapack_cholesky --n {n} --nb {block} --p {p} --q {q} "
+        "--bandwidth {bandwidth} --iters {iters}";
+    // The OpenMP drivers run with the thread count the host rates were calibrated at.
+    std::string band_cmd =
+        "OMP_NUM_THREADS={threads} ./build/band_cholesky --n {n} --bandwidth {bandwidth} "
         "--iters {iters}";
+    std::string gemm_cmd =
+        "OMP_NUM_THREADS={threads} ./build/gemm_bench --m {n} --n {n} --k {block} "
+        "--variant packed --iters {iters}";
+    std::string gp_cmd =
+        "OMP_NUM_THREADS={threads} ./build/gp_cholesky --n {n} --nb {block} --nrhs 1 "
+        "--inv-entries 16 --iters {iters}";
+    std::string pivoted_cmd =
+        "OMP_NUM_THREADS={threads} ./build/pivoted_cholesky --n {n} --nb {block} --tol 1e-4 "
+        "--iters {iters}";
+    // The server runs in the background: after a clean --shutdown we wait for it to
+    // write its trace, otherwise the EXIT trap kills it. {trace} puts --trace on the
+    // server, not the client.
+    std::string server_cmd =
+        "./build/chol_server --socket /tmp/chol_server_$$.sock --workers {threads} {trace} "
+        "> /dev/null & srv=$!; trap 'kill $srv 2>/dev/null' EXIT; "
+        "./build/chol_client --socket /tmp/chol_server_$$.sock --clients {threads} "
+        "--requests 100 --sizes 64,128,256 --shutdown && wait $srv";
+    // Host rates come from the vendor dgemm_ at --threads (default: one per ScaLAPACK
+    // rank); device rates need a GEMM_HIP=1 build for rocBLAS and are skipped when the
+    // command is empty.
+    std::string calibrate_cmd =
+        "OMP_NUM_THREADS={threads} OPENBLAS_NUM_THREADS={threads} ./build/gemm_bench "
+        "--calibrate --variant blas --m 2048 --n 2048 --k {block} --iters 3";
+    std::string device_calibrate_cmd;
+    std::string calibration_dir = "output";
+    std::string trace_dir;
     std::string out_jsonl = "output/bench_results.jsonl";
     std::string out_csv = "output/bench_results.csv";
 };
@@ -35,6 +74,7 @@ struct Args {
 struct CommandResult {
     int returncode = 0;
     double time_ms = 0.0;
+    double gflops = -1.0;
     long memory_kb = -1;
     std::string stdout_text;
     std::string stderr_text;
@@ -44,14 +84,20 @@ struct Entry {
     std::string timestamp;
     std::string method;
     int n = 0;
+    int bandwidth = -1;
     int block = 0;
     int p = 0;
     int q = 0;
     int iters = 0;
     int runs = 0;
+    int threads = 0;
     double time_ms = 0.0;
+    double gflops = -1.0;
     double memory_usage_kb = -1.0;
     double theoretical_time_ms = -1.0;
+    double efficiency_pct = -1.0;
+    double calib_gemm_gflops = -1.0;
+    double calib_stream_gbps = -1.0;
     double performance_difference_pct = 0.0;
     bool perf_diff_valid = false;
 };
@@ -69,6 +115,22 @@ bool file_exists(const std::string& path) {
     return f.good();
 }
 
+const char* const kCsvHeader =
+    "timestamp,method,n,block,p,q,iters,runs,time_ms,memory_usage_kb,memory_uasge_kb,"
+    "theoretical_time_ms,theoretical_time,performance_difference_pct,performance_difference,"
+    "bandwidth,gflops,efficiency_pct,calib_gemm_gflops,calib_stream_gbps,threads";
+
+// Rows are appended to an existing CSV, so its header must already have our columns.
+bool csv_header_matches(const std::string& path) {
+    std::ifstream in(path.c_str());
+    std::string header;
+    std::getline(in, header);
+    if (!header.empty() && header.back() == '\r') {
+        header.pop_back();
+    }
+    return header == kCsvHeader;
+}
+
 std::string read_file(const std::string& path) {
     std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
     std::ostringstream ss;
@@ -90,15 +152,17 @@ std::string format_cmd(const std::string& templ, const Args& args) {
     std::string out = templ;
     out = replace_all(out, "n", std::to_string(args.n));
     out = replace_all(out, "block", std::to_string(args.block));
+    out = replace_all(out, "bandwidth", std::to_string(args.bandwidth));
     out = replace_all(out, "p", std::to_string(args.p));
     out = replace_all(out, "q", std::to_string(args.q));
     out = replace_all(out, "iters", std::to_string(args.iters));
     out = replace_all(out, "np", std::to_string(args.p * args.q));
+    out = replace_all(out, "threads", std::to_string(args.threads));
     return out;
 }
 
-double parse_time_ms_from_json(const std::string& text) {
-    std::regex re("\"time_ms\"\\s*:\\s*([0-9]+(\\.[0-9]+)?)");
+double parse_number_from_json(const std::string& text, const std::string& key) {
+    std::regex re("\"" + key + "\"\\s*:\\s*([0-9]+(\\.[0-9]+)?)");
     std::smatch m;
     if (std::regex_search(text, m, re)) {
         return std::stod(m[1].str());
@@ -148,10 +212,11 @@ CommandResult run_command(const std::string& command) {
     result.time_ms = elapsed.count();
     result.memory_kb = usage.ru_maxrss;
 
-    double parsed = parse_time_ms_from_json(result.stdout_text);
+    double parsed = parse_number_from_json(result.stdout_text, "time_ms");
     if (parsed >= 0.0) {
         result.time_ms = parsed;
     }
+    result.gflops = parse_number_from_json(result.stdout_text, "gflops");
 
     return result;
 }
@@ -167,12 +232,176 @@ double average(const std::vector<double>& values) {
     return sum / static_cast<double>(values.size());
 }
 
-double theoretical_time_ms(int n, double peak_tflops) {
-    if (peak_tflops <= 0.0) {
+struct Rates {
+    double gemm_gflops = -1.0;
+    double stream_gbps = -1.0;
+
+    bool valid() const { return gemm_gflops > 0.0 && stream_gbps > 0.0; }
+};
+
+struct Calibration {
+    std::string host;
+    Rates host_rates;
+    Rates device_rates;
+};
+
+std::string host_name() {
+    char buf[256] = {0};
+    if (gethostname(buf, sizeof(buf) - 1) != 0 || buf[0] == '\0') {
+        return "unknown";
+    }
+    return std::string(buf);
+}
+
+Rates measure_rates(const std::string& command) {
+    Rates rates;
+    CommandResult outcome = run_command(command);
+    if (outcome.returncode != 0) {
+        std::cerr << "calibration failed: " << command << "\n" << outcome.stderr_text << "\n";
+        return rates;
+    }
+    rates.gemm_gflops = parse_number_from_json(outcome.stdout_text, "gemm_gflops");
+    rates.stream_gbps = parse_number_from_json(outcome.stdout_text, "stream_gbps");
+    return rates;
+}
+
+std::string json_escape(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+// Vendor DGEMM and triad rates for this host at --threads and k = --block, cached in
+// <calibration_dir>/calibration_<host>_t<threads>_k<block>.json so only the first run
+// at each setting pays for them. The cache also records the formatted commands, and a
+// side whose command changed (e.g. via --calibrate-cmd) is measured again.
+Calibration load_calibration(const Args& args) {
+    Calibration cal;
+    cal.host = host_name();
+    const std::string path = args.calibration_dir + "/calibration_" + cal.host + "_t" +
+                             std::to_string(args.threads) + "_k" + std::to_string(args.block) +
+                             ".json";
+    const std::string host_cmd = format_cmd(args.calibrate_cmd, args);
+    const std::string device_cmd = format_cmd(args.device_calibrate_cmd, args);
+    if (!args.recalibrate && file_exists(path)) {
+        std::string text = read_file(path);
+        if (text.find("\"host_cmd\":\"" + json_escape(host_cmd) + "\"") != std::string::npos) {
+            cal.host_rates.gemm_gflops = parse_number_from_json(text, "host_gemm_gflops");
+            cal.host_rates.stream_gbps = parse_number_from_json(text, "host_stream_gbps");
+        }
+        if (text.find("\"device_cmd\":\"" + json_escape(device_cmd) + "\"") !=
+            std::string::npos) {
+            cal.device_rates.gemm_gflops = parse_number_from_json(text, "device_gemm_gflops");
+            cal.device_rates.stream_gbps = parse_number_from_json(text, "device_stream_gbps");
+        }
+    }
+
+    bool changed = false;
+    if (!cal.host_rates.valid() && !host_cmd.empty()) {
+        cal.host_rates = measure_rates(host_cmd);
+        changed = true;
+    }
+    if (!cal.device_rates.valid() && !device_cmd.empty()) {
+        cal.device_rates = measure_rates(device_cmd);
+        changed = true;
+    }
+    if (changed) {
+        std::ofstream out(path, std::ios::out | std::ios::trunc);
+        if (!out.good()) {
+            std::cerr << "Failed to write " << path << "\n";
+            return cal;
+        }
+        out << "{\"timestamp\":\"" << now_iso_utc() << "\",";
+        out << "\"host\":\"" << cal.host << "\",";
+        out << "\"threads\":" << args.threads << ",";
+        out << "\"block\":" << args.block << ",";
+        out << "\"host_cmd\":\"" << json_escape(host_cmd) << "\",";
+        out << "\"device_cmd\":\"" << json_escape(device_cmd) << "\",";
+        out << "\"host_gemm_gflops\":" << cal.host_rates.gemm_gflops << ",";
+        out << "\"host_stream_gbps\":" << cal.host_rates.stream_gbps << ",";
+        out << "\"device_gemm_gflops\":" << cal.device_rates.gemm_gflops << ",";
+        out << "\"device_stream_gbps\":" << cal.device_rates.stream_gbps << "}\n";
+    }
+    return cal;
+}
+
+// Roofline lower bound for a right-looking blocked Cholesky with block nb. Each
+// step's panel (potrf + trsm of an m x nb block) and trailing update (syrk of the
+// m x m remainder) is charged max(flops / F, bytes / B) on its own, so the narrow,
+// bandwidth-bound panels are not hidden behind the GEMM-rate updates. A banded
+// matrix limits m to the bandwidth.
+double cholesky_roofline_ms(int n, int nb, int bandwidth, const Rates& rates) {
+    if (!rates.valid() || n <= 0 || nb <= 0) {
+        return -1.0;
+    }
+    const double F = rates.gemm_gflops * 1e9;
+    const double B = rates.stream_gbps * 1e9;
+    double seconds = 0.0;
+    for (int k0 = 0; k0 < n; k0 += nb) {
+        const double kb = std::min(nb, n - k0);
+        double m = n - k0 - kb;
+        if (bandwidth >= 0) {
+            m = std::min(m, static_cast<double>(bandwidth));
+        }
+        const double panel_flops = kb * kb * kb / 3.0 + m * kb * kb;
+        const double panel_bytes = 8.0 * (kb * kb + 2.0 * m * kb);
+        const double update_flops = m * (m + 1.0) * kb;
+        const double update_bytes = 8.0 * (m * (m + 1.0) + m * kb);
+        seconds += std::max(panel_flops / F, panel_bytes / B);
+        seconds += std::max(update_flops / F, update_bytes / B);
+    }
+    return seconds * 1000.0;
+}
+
+// C = A * B with A n x k, B k x n: one pass over the operands and C at best.
+double gemm_roofline_ms(int n, int k, const Rates& rates) {
+    if (!rates.valid()) {
         return -1.0;
     }
-    double flops = (static_cast<double>(n) * n * n) / 3.0;
-    return (flops / (peak_tflops * 1e12)) * 1000.0;
+    const double flops = 2.0 * n * static_cast<double>(n) * k;
+    const double bytes = 8.0 * (2.0 * n * static_cast<double>(k) + 2.0 * n * n);
+    return std::max(flops / (rates.gemm_gflops * 1e9), bytes / (rates.stream_gbps * 1e9)) * 1000.0;
+}
+
+const Rates& rates_for(const std::string& method, const Calibration& cal) {
+    if (method == "hipsolver" || method == "rocsolver") {
+        return cal.device_rates;
+    }
+    return cal.host_rates;
+}
+
+// The dense drivers factor the full matrix even when it is banded; band_cholesky
+// picks its own tile size, so its bound uses the nb and bandwidth from its output.
+// Pivoted Cholesky has no bound here.
+double roofline_ms(const std::string& method, const Args& args, const Calibration& cal,
+                   const std::string& output) {
+    const Rates& rates = rates_for(method, cal);
+    if (method == "gemm") {
+        return gemm_roofline_ms(args.n, args.block, rates);
+    }
+    if (method == "band") {
+        const double nb = parse_number_from_json(output, "nb");
+        const double bandwidth = parse_number_from_json(output, "effective_bandwidth");
+        if (nb <= 0.0 || bandwidth < 0.0) {
+            return -1.0;
+        }
+        return cholesky_roofline_ms(args.n, static_cast<int>(nb), static_cast<int>(bandwidth),
+                                    rates);
+    }
+    if (method == "pivoted" || method == "server") {
+        return -1.0;
+    }
+    return cholesky_roofline_ms(args.n, args.block, -1, rates);
+}
+
+// Methods that factor the same matrix as pdpotrf; the rest solve a different problem.
+bool compares_to_scalapack(const std::string& method) {
+    return method != "gemm" && method != "gp_fused" && method != "pivoted" && method != "server";
 }
 
 Args parse_args(int argc, char** argv) {
@@ -190,14 +419,46 @@ Args parse_args(int argc, char** argv) {
             args.iters = std::atoi(argv[++i]);
         } else if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
             args.runs = std::atoi(argv[++i]);
-        } else if (std::strcmp(argv[i], "--peak-tflops") == 0 && i + 1 < argc) {
-            args.peak_tflops = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--bandwidth") == 0 && i + 1 < argc) {
+            args.bandwidth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            args.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--gemm") == 0) {
+            args.gemm = true;
+        } else if (std::strcmp(argv[i], "--gp") == 0) {
+            args.gp = true;
+        } else if (std::strcmp(argv[i], "--pivoted") == 0) {
+            args.pivoted = true;
+        } else if (std::strcmp(argv[i], "--server") == 0) {
+            args.server = true;
+        } else if (std::strcmp(argv[i], "--no-calibrate") == 0) {
+            args.calibrate = false;
+        } else if (std::strcmp(argv[i], "--recalibrate") == 0) {
+            args.recalibrate = true;
+        } else if (std::strcmp(argv[i], "--calibrate-cmd") == 0 && i + 1 < argc) {
+            args.calibrate_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--device-calibrate-cmd") == 0 && i + 1 < argc) {
+            args.device_calibrate_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--calibration-dir") == 0 && i + 1 < argc) {
+            args.calibration_dir = argv[++i];
         } else if (std::strcmp(argv[i], "--hip-cmd") == 0 && i + 1 < argc) {
             args.hip_cmd = argv[++i];
         } else if (std::strcmp(argv[i], "--roc-cmd") == 0 && i + 1 < argc) {
             args.roc_cmd = argv[++i];
         } else if (std::strcmp(argv[i], "--scalapack-cmd") == 0 && i + 1 < argc) {
             args.scalapack_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--band-cmd") == 0 && i + 1 < argc) {
+            args.band_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--gemm-cmd") == 0 && i + 1 < argc) {
+            args.gemm_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--gp-cmd") == 0 && i + 1 < argc) {
+            args.gp_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--pivoted-cmd") == 0 && i + 1 < argc) {
+            args.pivoted_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--server-cmd") == 0 && i + 1 < argc) {
+            args.server_cmd = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace-dir") == 0 && i + 1 < argc) {
+            args.trace_dir = argv[++i];
         } else if (std::strcmp(argv[i], "--out-jsonl") == 0 && i + 1 < argc) {
             args.out_jsonl = argv[++i];
         } else if (std::strcmp(argv[i], "--out-csv") == 0 && i + 1 < argc) {
@@ -207,6 +468,9 @@ Args parse_args(int argc, char** argv) {
     if (args.n <= 0) {
         throw std::runtime_error("--n is required.");
     }
+    if (args.threads <= 0) {
+        args.threads = args.p * args.q;
+    }
     return args;
 }
 }  // namespace
@@ -219,19 +483,64 @@ int main(int argc, char** argv) {
         std::cerr << "Argument error: " << ex.what() << "\n";
         return 1;
     }
+    if (file_exists(args.out_csv) && !csv_header_matches(args.out_csv)) {
+        std::cerr << args.out_csv << " has a different column layout; pass a new --out-csv\n";
+        return 4;
+    }
 
     std::vector<std::pair<std::string, std::string>> methods = {
         {"hipsolver", args.hip_cmd},
         {"rocsolver", args.roc_cmd},
         {"scalapack", args.scalapack_cmd},
     };
+    // Band storage only makes sense for a banded matrix; a negative bandwidth is dense.
+    if (args.bandwidth >= 0) {
+        methods.push_back({"band", args.band_cmd});
+    }
+    // The trailing-update GEMM (n x n x block) is recorded for reference, not compared.
+    if (args.gemm) {
+        methods.push_back({"gemm", args.gemm_cmd});
+    }
+    // Fused factor + log det + solve + selected inverse; its own line reports the
+    // per-output breakdown against separate passes.
+    if (args.gp) {
+        methods.push_back({"gp_fused", args.gp_cmd});
+    }
+    // Low-rank approximation of a kernel matrix; the line carries rank, error and the
+    // dense factorization time for the same matrix.
+    if (args.pivoted) {
+        methods.push_back({"pivoted", args.pivoted_cmd});
+    }
+    // Mixed-size factor/solve load against a chol_server started for the run; time_ms
+    // covers the whole load, and the line carries throughput and latency percentiles.
+    if (args.server) {
+        methods.push_back({"server", args.server_cmd});
+    }
+
+    Calibration calibration;
+    if (args.calibrate) {
+        calibration = load_calibration(args);
+    }
 
     std::vector<Entry> results;
     for (const auto& method : methods) {
         std::vector<double> run_times;
         std::vector<double> run_memories;
+        std::vector<double> run_gflops;
+        std::string last_output;
         for (int i = 0; i < args.runs; ++i) {
             std::string command = format_cmd(method.second, args);
+            std::string trace_flag;
+            if (!args.trace_dir.empty()) {
+                trace_flag = "--trace " + args.trace_dir + "/" + method.first + "_n" +
+                             std::to_string(args.n) + "_run" + std::to_string(i) + ".json";
+            }
+            // Templates that run more than one binary say where the flag goes.
+            if (command.find("{trace}") != std::string::npos) {
+                command = replace_all(command, "trace", trace_flag);
+            } else if (!trace_flag.empty()) {
+                command += " " + trace_flag;
+            }
             CommandResult outcome = run_command(command);
             if (outcome.returncode != 0) {
                 std::cerr << method.first << " failed: " << command << "\n"
@@ -239,6 +548,10 @@ int main(int argc, char** argv) {
                 return 2;
             }
             run_times.push_back(outcome.time_ms);
+            last_output = outcome.stdout_text;
+            if (outcome.gflops >= 0.0) {
+                run_gflops.push_back(outcome.gflops);
+            }
             if (outcome.memory_kb >= 0) {
                 run_memories.push_back(static_cast<double>(outcome.memory_kb));
             }
@@ -248,14 +561,23 @@ int main(int argc, char** argv) {
         entry.timestamp = now_iso_utc();
         entry.method = method.first;
         entry.n = args.n;
+        entry.bandwidth = args.bandwidth;
         entry.block = args.block;
         entry.p = args.p;
         entry.q = args.q;
         entry.iters = args.iters;
         entry.runs = args.runs;
+        entry.threads = args.threads;
         entry.time_ms = average(run_times);
+        entry.gflops = average(run_gflops);
         entry.memory_usage_kb = average(run_memories);
-        entry.theoretical_time_ms = theoretical_time_ms(args.n, args.peak_tflops);
+        entry.theoretical_time_ms = roofline_ms(entry.method, args, calibration, last_output);
+        if (entry.theoretical_time_ms > 0.0 && entry.time_ms > 0.0) {
+            entry.efficiency_pct = entry.theoretical_time_ms / entry.time_ms * 100.0;
+        }
+        const Rates& rates = rates_for(entry.method, calibration);
+        entry.calib_gemm_gflops = rates.gemm_gflops;
+        entry.calib_stream_gbps = rates.stream_gbps;
         results.push_back(entry);
     }
 
@@ -268,7 +590,8 @@ int main(int argc, char** argv) {
     }
     if (scalapack) {
         for (auto& entry : results) {
-            if (entry.method != "scalapack" && scalapack->time_ms > 0.0) {
+            if (entry.method != "scalapack" && compares_to_scalapack(entry.method) &&
+                scalapack->time_ms > 0.0) {
                 entry.performance_difference_pct =
                     ((entry.time_ms - scalapack->time_ms) / scalapack->time_ms) * 100.0;
                 entry.perf_diff_valid = true;
@@ -304,6 +627,12 @@ int main(int argc, char** argv) {
             jsonl << "\"performance_difference_pct\":null,";
             jsonl << "\"performance_difference\":null";
         }
+        jsonl << ",\"bandwidth\":" << entry.bandwidth;
+        jsonl << ",\"gflops\":" << entry.gflops;
+        jsonl << ",\"efficiency_pct\":" << entry.efficiency_pct;
+        jsonl << ",\"calib_gemm_gflops\":" << entry.calib_gemm_gflops;
+        jsonl << ",\"calib_stream_gbps\":" << entry.calib_stream_gbps;
+        jsonl << ",\"threads\":" << entry.threads;
         jsonl << "}\n";
     }
 
@@ -314,9 +643,7 @@ int main(int argc, char** argv) {
         return 4;
     }
     if (!csv_exists) {
-        csv << "timestamp,method,n,block,p,q,iters,runs,time_ms,memory_usage_kb,"
-               "memory_uasge_kb,theoretical_time_ms,theoretical_time,performance_difference_pct,"
-               "performance_difference\n";
+        csv << kCsvHeader << "\n";
     }
     for (const auto& entry : results) {
         csv << entry.timestamp << ",";
@@ -334,11 +661,17 @@ int main(int argc, char** argv) {
         csv << entry.theoretical_time_ms << ",";
         if (entry.perf_diff_valid) {
             csv << entry.performance_difference_pct << ",";
-            csv << entry.performance_difference_pct << "\n";
+            csv << entry.performance_difference_pct << ",";
         } else {
             csv << ",";
-            csv << "\n";
+            csv << ",";
         }
+        csv << entry.bandwidth << ",";
+        csv << entry.gflops << ",";
+        csv << entry.efficiency_pct << ",";
+        csv << entry.calib_gemm_gflops << ",";
+        csv << entry.calib_stream_gbps << ",";
+        csv << entry.threads << "\n";
     }
 
     std::cout << "{\"status\":\"ok\",\"results\":" << results.size() << "}\n";
@@ -17,7 +17,13 @@ module load scalapack
 
 export OMP_NUM_THREADS=1
 
-make all
+# Bandwidths for the banded sweep; each run also records the dense methods on the
+# same banded matrix so time can be charted against bandwidth.
+BANDWIDTHS="${BANDWIDTHS:-16 64 256}"
+
+# GEMM_HIP=1 adds the rocBLAS variant to gemm_bench so run_bench can calibrate the DCU.
+make all GEMM_HIP=1
+DEVICE_CALIBRATE="./build/gemm_bench --calibrate --variant rocblas --m 4096 --n 4096 --k 256 --iters 3"
 
 ./build/run_bench \
   --n 8192 \
@@ -26,4 +32,20 @@ make all
   --q 2 \
   --iters 3 \
   --runs 1 \
-  --peak-tflops 0.0
+  --gemm \
+  --gp \
+  --pivoted \
+  --server \
+  --device-calibrate-cmd "${DEVICE_CALIBRATE}"
+
+for bw in ${BANDWIDTHS}; do
+  ./build/run_bench \
+    --n 8192 \
+    --block 256 \
+    --p 2 \
+    --q 2 \
+    --bandwidth "${bw}" \
+    --iters 3 \
+    --runs 1 \
+    --device-calibrate-cmd "${DEVICE_CALIBRATE}"
+done
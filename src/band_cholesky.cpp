@@ -0,0 +1,246 @@
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cpu_kernels.h"
+#include "trace.h"
+
+namespace {
+struct Args {
+    int n = 1024;
+    int bandwidth = 64;
+    int requested_bandwidth = 64;
+    int nb = 0;
+    int iters = 3;
+    std::string trace_path;
+};
+
+Args parse_args(int argc, char** argv) {
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            args.n = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--bandwidth") == 0 && i + 1 < argc) {
+            args.bandwidth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nb") == 0 && i + 1 < argc) {
+            args.nb = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            args.iters = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            args.trace_path = argv[++i];
+        }
+    }
+    if (args.n <= 0 || args.iters <= 0) {
+        throw std::runtime_error("--n and --iters must be positive");
+    }
+    // A negative bandwidth means "dense" for the other drivers; here it is the full matrix.
+    // Both values are reported so callers can match the line to the bandwidth they asked for.
+    args.requested_bandwidth = args.bandwidth;
+    if (args.bandwidth < 0 || args.bandwidth > args.n - 1) {
+        args.bandwidth = args.n - 1;
+    }
+    // Tiles of at most 128 that the band fills exactly: a fixed cap would make b = 129 pay
+    // for two full tile diagonals, so time steps with tile rounding instead of n * b^2.
+    if (args.nb <= 0) {
+        const int tiles = std::max(1, (args.bandwidth + 127) / 128);
+        args.nb = std::max(16, (args.bandwidth + tiles - 1) / tiles);
+    }
+    return args;
+}
+
+// Tiled band layout: tile (I, J) with 0 <= I - J <= bt is an nb x nb column-major
+// block, stored at ((J * (bt + 1)) + (I - J)) * nb * nb. Tiles outside the band are
+// structurally zero and stay zero during factorization, so nothing else is stored.
+struct BandTiles {
+    int n = 0;
+    int nb = 0;
+    int nt = 0;
+    int bt = 0;
+    std::vector<double> data;
+
+    BandTiles(int n_, int bandwidth, int nb_) : n(n_), nb(nb_) {
+        nt = (n + nb - 1) / nb;
+        bt = std::min((bandwidth + nb - 1) / nb, nt - 1);
+        data.assign(static_cast<size_t>(nt) * (bt + 1) * nb * nb, 0.0);
+    }
+
+    int rows(int tile) const { return std::min(nb, n - tile * nb); }
+
+    int last(int tile) const { return std::min(nt - 1, tile + bt); }
+
+    double* tile(int i, int j) {
+        return data.data() + (static_cast<size_t>(j) * (bt + 1) + (i - j)) * nb * nb;
+    }
+
+    const double* tile(int i, int j) const {
+        return data.data() + (static_cast<size_t>(j) * (bt + 1) + (i - j)) * nb * nb;
+    }
+
+    double& at(int row, int col) {
+        return tile(row / nb, col / nb)[(row % nb) + static_cast<size_t>(col % nb) * nb];
+    }
+
+    double at(int row, int col) const {
+        return tile(row / nb, col / nb)[(row % nb) + static_cast<size_t>(col % nb) * nb];
+    }
+};
+
+// Fills the lower band of a diagonally dominant SPD matrix column by column. The
+// hipsolver/rocsolver drivers use the same sequence for --bandwidth, so they factor
+// exactly this A in dense storage.
+template <typename Store>
+void generate_band_spd(int n, int bandwidth, Store store) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int col = 0; col < n; ++col) {
+        int last = std::min(n - 1, col + bandwidth);
+        for (int row = col; row <= last; ++row) {
+            double val = dist(rng);
+            if (row == col) {
+                val += static_cast<double>(2 * bandwidth + 1);
+            }
+            store(row, col, val);
+        }
+    }
+}
+
+// Right-looking tile Cholesky restricted to the band tiles. Each step k touches at
+// most (bt + 1)^2 tiles, so the cost is O(n * b^2) rather than O(n^3).
+int factor(BandTiles& A) {
+    const int nb = A.nb;
+    std::atomic<int> info(0);
+#pragma omp parallel
+#pragma omp single
+    for (int k = 0; k < A.nt; ++k) {
+        const int kn = A.rows(k);
+        double* akk = A.tile(k, k);
+#pragma omp task depend(inout : akk[0]) shared(info)
+        {
+            CHOL_TRACE_SCOPE("potrf");
+            int local = chol::potrf_lower(kn, akk, nb);
+            if (local != 0) {
+                int expected = 0;
+                info.compare_exchange_strong(expected, k * nb + local);
+            }
+        }
+        for (int i = k + 1; i <= A.last(k); ++i) {
+            double* aik = A.tile(i, k);
+            const int im = A.rows(i);
+#pragma omp task depend(in : akk[0]) depend(inout : aik[0]) shared(info)
+            if (info == 0) {
+                CHOL_TRACE_SCOPE("trsm");
+                chol::trsm_right_lower_trans(im, kn, akk, nb, aik, nb);
+            }
+        }
+        for (int j = k + 1; j <= A.last(k); ++j) {
+            double* ajk = A.tile(j, k);
+            const int jn = A.rows(j);
+            for (int i = j; i <= A.last(k); ++i) {
+                double* aik = A.tile(i, k);
+                double* aij = A.tile(i, j);
+                const int im = A.rows(i);
+                if (i == j) {
+#pragma omp task depend(in : ajk[0]) depend(inout : aij[0]) shared(info)
+                    if (info == 0) {
+                        CHOL_TRACE_SCOPE("syrk");
+                        chol::syrk_lower_sub(jn, kn, ajk, nb, aij, nb);
+                    }
+                } else {
+#pragma omp task depend(in : aik[0], ajk[0]) depend(inout : aij[0]) shared(info)
+                    if (info == 0) {
+                        CHOL_TRACE_SCOPE("gemm");
+                        chol::gemm_nt_sub(im, jn, kn, aik, nb, ajk, nb, aij, nb);
+                    }
+                }
+            }
+        }
+    }
+    return info.load();
+}
+
+// Max |A - L * L^T| over the band, relative to max |A|.
+double band_residual(const BandTiles& L, const BandTiles& A, int bandwidth) {
+    double max_err = 0.0;
+    double max_a = 0.0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(max : max_err, max_a)
+    for (int col = 0; col < L.n; ++col) {
+        int last = std::min(L.n - 1, col + bandwidth);
+        for (int row = col; row <= last; ++row) {
+            double sum = 0.0;
+            for (int p = std::max(0, row - bandwidth); p <= col; ++p) {
+                sum += L.at(row, p) * L.at(col, p);
+            }
+            double a = A.at(row, col);
+            max_err = std::max(max_err, std::fabs(a - sum));
+            max_a = std::max(max_a, std::fabs(a));
+        }
+    }
+    return max_a > 0.0 ? max_err / max_a : max_err;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    try {
+        args = parse_args(argc, argv);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Argument error: %s\n", ex.what());
+        return 1;
+    }
+    const int n = args.n;
+    if (!args.trace_path.empty()) {
+        chol_trace_enable();
+    }
+
+    CHOL_TRACE_BEGIN(t_generate);
+    BandTiles Aorig(n, args.bandwidth, args.nb);
+    generate_band_spd(n, args.bandwidth,
+                      [&](int row, int col, double val) { Aorig.at(row, col) = val; });
+    BandTiles A = Aorig;
+    CHOL_TRACE_END(t_generate, "generate");
+
+    double total_ms = 0.0;
+    for (int iter = 0; iter < args.iters; ++iter) {
+        {
+            CHOL_TRACE_SCOPE("copy");
+            A.data = Aorig.data;
+        }
+        auto start = std::chrono::steady_clock::now();
+        CHOL_TRACE_BEGIN(t_factor);
+        int info = factor(A);
+        CHOL_TRACE_END(t_factor, "factor");
+        auto stop = std::chrono::steady_clock::now();
+        if (info != 0) {
+            std::fprintf(stderr, "band factorization failed with info=%d\n", info);
+            return 1;
+        }
+        total_ms += std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+
+    CHOL_TRACE_BEGIN(t_residual);
+    double residual = band_residual(A, Aorig, args.bandwidth);
+    CHOL_TRACE_END(t_residual, "residual");
+    double avg_ms = total_ms / static_cast<double>(args.iters);
+    std::printf(
+        "{\"method\":\"band\",\"n\":%d,\"bandwidth\":%d,\"effective_bandwidth\":%d,\"nb\":%d,"
+        "\"threads\":%d,\"iters\":%d,\"time_ms\":%.6f,\"residual\":%.3e",
+        n, args.requested_bandwidth, args.bandwidth, args.nb, omp_get_max_threads(), args.iters, avg_ms, residual);
+    if (!args.trace_path.empty()) {
+        if (chol_trace_dump(args.trace_path.c_str(), "band_cholesky") != 0) {
+            std::fprintf(stderr, "Failed to write trace %s\n", args.trace_path.c_str());
+        }
+        chol_trace_report(stdout, total_ms);
+    }
+    std::printf("}\n");
+    return 0;
+}
@@ -0,0 +1,347 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chol_server.h"
+#include "dense_cholesky.h"
+
+// Load generator for chol_server: --clients concurrent connections each send
+// --requests factor/solve requests of sizes drawn from --sizes, one at a time, and
+// check every answer against a reference computed up front: a relative log-det or
+// solution error above --tol counts as an error. Prints one JSON line
+// with end-to-end throughput and latency percentiles plus the server's own view.
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Args {
+    std::string socket_path = chol::kDefaultSocketPath;
+    int clients = 8;
+    int requests = 200;
+    std::vector<int> sizes = {64, 128, 256};
+    int nrhs = 1;
+    std::string op = "mix";
+    int connect_timeout_ms = 5000;
+    double tol = 1e-10;
+    bool shutdown = false;
+};
+
+std::vector<int> parse_sizes(const std::string& text) {
+    std::vector<int> sizes;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int n = std::atoi(item.c_str());
+        if (n <= 0) {
+            throw std::runtime_error("--sizes must be a comma-separated list of positive sizes");
+        }
+        sizes.push_back(n);
+    }
+    if (sizes.empty()) {
+        throw std::runtime_error("--sizes must not be empty");
+    }
+    return sizes;
+}
+
+Args parse_args(int argc, char** argv) {
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            args.socket_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+            args.clients = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+            args.requests = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            args.sizes = parse_sizes(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nrhs") == 0 && i + 1 < argc) {
+            args.nrhs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--op") == 0 && i + 1 < argc) {
+            args.op = argv[++i];
+        } else if (std::strcmp(argv[i], "--connect-timeout-ms") == 0 && i + 1 < argc) {
+            args.connect_timeout_ms = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tol") == 0 && i + 1 < argc) {
+            args.tol = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--shutdown") == 0) {
+            args.shutdown = true;
+        }
+    }
+    if (args.clients <= 0 || args.requests <= 0 || args.nrhs <= 0) {
+        throw std::runtime_error("--clients, --requests and --nrhs must be positive");
+    }
+    if (args.op != "factor" && args.op != "solve" && args.op != "mix") {
+        throw std::runtime_error("--op must be factor, solve or mix");
+    }
+    if (args.socket_path.size() >= sizeof(sockaddr_un::sun_path)) {
+        throw std::runtime_error("--socket path is too long");
+    }
+    return args;
+}
+
+// Retries until the server is listening, so the client can be started right
+// after the server in the same shell.
+int connect_server(const Args& args) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, args.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    const Clock::time_point deadline =
+        Clock::now() + std::chrono::milliseconds(args.connect_timeout_ms);
+    for (;;) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            throw std::runtime_error("socket failed");
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        if (Clock::now() >= deadline) {
+            throw std::runtime_error("cannot connect to " + args.socket_path);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+// One SPD test matrix per size with B = A * ones, so a solve must return ones,
+// and the log-determinant from a local factorization.
+struct Problem {
+    int n = 0;
+    std::vector<double> A;
+    std::vector<double> B;
+    double logdet = 0.0;
+};
+
+Problem make_problem(int n, int nrhs, unsigned seed) {
+    Problem p;
+    p.n = n;
+    const size_t elems = static_cast<size_t>(n) * n;
+    p.A.resize(elems);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int row = 0; row < n; ++row) {
+        for (int col = 0; col <= row; ++col) {
+            double val = dist(rng);
+            p.A[row * static_cast<size_t>(n) + col] = val;
+            p.A[col * static_cast<size_t>(n) + row] = val;
+        }
+        p.A[row * static_cast<size_t>(n) + row] += static_cast<double>(n);
+    }
+    p.B.assign(static_cast<size_t>(n) * nrhs, 0.0);
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            p.B[i] += p.A[i + static_cast<size_t>(j) * n];
+        }
+    }
+    for (int c = 1; c < nrhs; ++c) {
+        std::copy(p.B.begin(), p.B.begin() + n, p.B.begin() + static_cast<size_t>(c) * n);
+    }
+    std::vector<double> L = p.A;
+    if (chol::factor(n, std::min(64, n), L.data(), n) != 0) {
+        throw std::runtime_error("test matrix is not SPD");
+    }
+    for (int i = 0; i < n; ++i) {
+        p.logdet += 2.0 * std::log(L[i + static_cast<size_t>(i) * n]);
+    }
+    return p;
+}
+
+struct ClientResult {
+    std::vector<double> latencies_us;
+    double max_err = 0.0;
+    long long batched = 0;
+    int errors = 0;
+};
+
+void run_client(int id, const Args& args, const std::vector<Problem>& problems,
+                ClientResult& out) {
+    const int max_n = *std::max_element(args.sizes.begin(), args.sizes.end());
+    const size_t bytes =
+        (static_cast<size_t>(max_n) * max_n + static_cast<size_t>(max_n) * args.nrhs) *
+        sizeof(double);
+    char name[64];
+    std::snprintf(name, sizeof(name), "/chol_client_%d_%d", static_cast<int>(getpid()), id);
+    int shm = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (shm < 0) {
+        throw std::runtime_error(std::string("shm_open failed for ") + name);
+    }
+    if (ftruncate(shm, static_cast<off_t>(bytes)) != 0) {
+        close(shm);
+        shm_unlink(name);
+        throw std::runtime_error(std::string("ftruncate failed for ") + name);
+    }
+    void* map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0);
+    close(shm);
+    if (map == MAP_FAILED) {
+        shm_unlink(name);
+        throw std::runtime_error("mmap failed");
+    }
+    double* seg = static_cast<double*>(map);
+
+    int fd = -1;
+    try {
+        fd = connect_server(args);
+    } catch (...) {
+        munmap(map, bytes);
+        shm_unlink(name);
+        throw;
+    }
+    std::mt19937 rng(4321 + id);
+    out.latencies_us.reserve(args.requests);
+    for (int r = 0; r < args.requests; ++r) {
+        const Problem& p = problems[rng() % problems.size()];
+        const int n = p.n;
+        const size_t a_elems = static_cast<size_t>(n) * n;
+        bool solve = args.op == "solve" || (args.op == "mix" && (rng() & 1));
+
+        chol::Request req;
+        req.id = (static_cast<uint64_t>(id) << 32) | static_cast<uint64_t>(r);
+        req.op = solve ? chol::kOpSolve : chol::kOpFactor;
+        req.n = n;
+        req.nrhs = solve ? args.nrhs : 0;
+        std::snprintf(req.shm_name, sizeof(req.shm_name), "%s", name);
+
+        const Clock::time_point start = Clock::now();
+        std::memcpy(seg, p.A.data(), a_elems * sizeof(double));
+        if (solve) {
+            std::memcpy(seg + a_elems, p.B.data(), p.B.size() * sizeof(double));
+        }
+        chol::Response resp;
+        if (!chol::write_full(fd, &req, sizeof(req)) ||
+            !chol::read_full(fd, &resp, sizeof(resp))) {
+            ++out.errors;
+            break;
+        }
+        out.latencies_us.push_back(
+            std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+
+        if (resp.info != 0 || resp.id != req.id) {
+            ++out.errors;
+            continue;
+        }
+        out.batched += resp.batch;
+        double err = std::fabs(resp.logdet - p.logdet) / std::max(1.0, std::fabs(p.logdet));
+        if (solve) {
+            for (size_t i = 0; i < p.B.size(); ++i) {
+                err = std::max(err, std::fabs(seg[a_elems + i] - 1.0));
+            }
+        }
+        out.max_err = std::max(out.max_err, err);
+        if (!(err <= args.tol)) {
+            ++out.errors;
+        }
+    }
+    close(fd);
+    munmap(map, bytes);
+    shm_unlink(name);
+}
+
+// Sends a single control request on its own connection.
+template <typename Reply>
+Reply control(const Args& args, uint32_t op) {
+    int fd = connect_server(args);
+    chol::Request req;
+    req.op = op;
+    Reply reply;
+    bool ok =
+        chol::write_full(fd, &req, sizeof(req)) && chol::read_full(fd, &reply, sizeof(reply));
+    close(fd);
+    if (!ok) {
+        throw std::runtime_error("control request failed");
+    }
+    return reply;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    try {
+        args = parse_args(argc, argv);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Argument error: %s\n", ex.what());
+        return 1;
+    }
+
+    std::vector<Problem> problems;
+    for (size_t s = 0; s < args.sizes.size(); ++s) {
+        problems.push_back(make_problem(args.sizes[s], args.nrhs, 1234 + static_cast<unsigned>(s)));
+    }
+
+    std::vector<ClientResult> results(args.clients);
+    std::vector<std::thread> threads;
+    std::mutex error_mu;
+    std::string error;
+    const Clock::time_point start = Clock::now();
+    for (int c = 0; c < args.clients; ++c) {
+        threads.emplace_back([&, c] {
+            try {
+                run_client(c, args, problems, results[c]);
+            } catch (const std::exception& ex) {
+                std::lock_guard<std::mutex> lock(error_mu);
+                error = ex.what();
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    const double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (!error.empty()) {
+        std::fprintf(stderr, "Client error: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<double> latencies;
+    double max_err = 0.0;
+    long long batched = 0;
+    int errors = 0;
+    for (const ClientResult& r : results) {
+        latencies.insert(latencies.end(), r.latencies_us.begin(), r.latencies_us.end());
+        max_err = std::max(max_err, r.max_err);
+        batched += r.batched;
+        errors += r.errors;
+    }
+
+    chol::ServerStats server;
+    try {
+        server = control<chol::ServerStats>(args, chol::kOpStats);
+        if (args.shutdown) {
+            control<chol::Response>(args, chol::kOpShutdown);
+        }
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Client error: %s\n", ex.what());
+        return 1;
+    }
+
+    std::string sizes;
+    for (size_t s = 0; s < args.sizes.size(); ++s) {
+        sizes += (s ? "," : "") + std::to_string(args.sizes[s]);
+    }
+    const size_t done = latencies.size();
+    std::printf(
+        "{\"method\":\"server\",\"clients\":%d,\"requests\":%zu,\"sizes\":\"%s\",\"op\":\"%s\","
+        "\"nrhs\":%d,\"time_ms\":%.6f,\"throughput_rps\":%.3f,\"p50_us\":%.3f,\"p95_us\":%.3f,"
+        "\"p99_us\":%.3f,\"mean_batch\":%.3f,\"server_p99_us\":%.3f,\"server_queue_us\":%.3f,"
+        "\"errors\":%d,\"max_err\":%.6e}\n",
+        args.clients, done, sizes.c_str(), args.op.c_str(), args.nrhs, total_ms,
+        total_ms > 0.0 ? done / (total_ms * 1e-3) : 0.0, chol::percentile(latencies, 0.50),
+        chol::percentile(latencies, 0.95), chol::percentile(latencies, 0.99),
+        done > 0 ? static_cast<double>(batched) / static_cast<double>(done) : 0.0, server.p99_us,
+        server.mean_queue_us, errors, max_err);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,571 @@
+#include <fcntl.h>
+#include <omp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chol_server.h"
+#include "dense_cholesky.h"
+#include "trace.h"
+
+// Long-running factorization daemon. Requests arrive on a Unix socket with their
+// matrices in client-owned shared memory; same-size requests are held for up to
+// --window-us and queued back to back for a fixed pool of single-threaded workers,
+// which share each batch, so a burst of small matrices costs one dispatch instead
+// of one process each.
+// Stops on kOpShutdown or SIGINT/SIGTERM and prints a JSON summary line.
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Args {
+    std::string socket_path = chol::kDefaultSocketPath;
+    int workers = 0;
+    int window_us = 200;
+    int max_batch = 16;
+    int max_n = 1024;
+    int max_nrhs = 16;
+    int nb = 64;
+    std::string trace_path;
+};
+
+Args parse_args(int argc, char** argv) {
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            args.socket_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            args.workers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--window-us") == 0 && i + 1 < argc) {
+            args.window_us = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-batch") == 0 && i + 1 < argc) {
+            args.max_batch = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-n") == 0 && i + 1 < argc) {
+            args.max_n = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-nrhs") == 0 && i + 1 < argc) {
+            args.max_nrhs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nb") == 0 && i + 1 < argc) {
+            args.nb = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            args.trace_path = argv[++i];
+        }
+    }
+    if (args.workers <= 0) {
+        args.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (args.window_us < 0 || args.max_batch <= 0 || args.max_n <= 0 || args.max_nrhs <= 0 ||
+        args.nb <= 0) {
+        throw std::runtime_error(
+            "--window-us must be non-negative; --max-batch, --max-n, --max-nrhs and --nb must "
+            "be positive");
+    }
+    if (args.socket_path.size() >= sizeof(sockaddr_un::sun_path)) {
+        throw std::runtime_error("--socket path is too long");
+    }
+    return args;
+}
+
+volatile sig_atomic_t g_stop = 0;
+
+void on_signal(int) { g_stop = 1; }
+
+double us_between(Clock::time_point start, Clock::time_point stop) {
+    return std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+// A client connection and the shared-memory segment it last named. Queued requests
+// hold a shared_ptr, so a disconnect cannot unmap memory a worker is still using, and
+// busy rejects a second factor/solve (which could remap the segment) until the first
+// one has been answered. Replies come from both the poll thread and the workers.
+//
+// The socket is non-blocking: a request is assembled in rx across as many reads as
+// the client needs, so a slow or stalled client never holds up the poll thread. A
+// reply that does not fit in the socket buffer (a client that never reads) is dropped.
+struct Connection {
+    int fd = -1;
+    std::string shm_name;
+    void* map = nullptr;
+    size_t map_bytes = 0;
+    std::atomic<bool> busy{false};
+    std::mutex write_mu;
+    char rx[sizeof(chol::Request)];
+    size_t rx_len = 0;
+
+    explicit Connection(int fd_) : fd(fd_) {}
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    ~Connection() {
+        detach();
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool reply(const void* buf, size_t len) {
+        std::lock_guard<std::mutex> lock(write_mu);
+        return chol::write_full(fd, buf, len);
+    }
+
+    // One read toward the next request; true once a whole one is in req. Sets *closed
+    // on end-of-stream or a socket error.
+    bool receive(chol::Request& req, bool* closed) {
+        ssize_t got = recv(fd, rx + rx_len, sizeof(rx) - rx_len, 0);
+        if (got < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return false;
+        }
+        if (got <= 0) {
+            *closed = true;
+            return false;
+        }
+        rx_len += static_cast<size_t>(got);
+        if (rx_len < sizeof(rx)) {
+            return false;
+        }
+        std::memcpy(&req, rx, sizeof(req));
+        rx_len = 0;
+        return true;
+    }
+
+    void detach() {
+        if (map) {
+            munmap(map, map_bytes);
+        }
+        map = nullptr;
+        map_bytes = 0;
+        shm_name.clear();
+    }
+
+    // Clients reuse one segment, so it is mapped once per connection, not per request.
+    bool attach(const char* name) {
+        if (map && shm_name == name) {
+            return true;
+        }
+        detach();
+        int shm = shm_open(name, O_RDWR, 0);
+        if (shm < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(shm, &st) != 0 || st.st_size <= 0) {
+            close(shm);
+            return false;
+        }
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE,
+                       MAP_SHARED, shm, 0);
+        close(shm);
+        if (p == MAP_FAILED) {
+            return false;
+        }
+        map = p;
+        map_bytes = static_cast<size_t>(st.st_size);
+        shm_name = name;
+        return true;
+    }
+};
+
+struct Pending {
+    std::shared_ptr<Connection> conn;
+    chol::Request req;
+    Clock::time_point arrival;
+};
+
+struct Batch {
+    int n = 0;
+    std::vector<Pending> items;
+};
+
+// Completed-request counters plus the most recent latencies for percentiles.
+struct StatsLog {
+    static constexpr size_t kLatencyWindow = size_t(1) << 20;
+
+    std::mutex mu;
+    uint64_t requests = 0;
+    uint64_t batches = 0;
+    double queue_us_sum = 0.0;
+    std::vector<double> latencies_us;
+    bool started = false;
+    Clock::time_point first_arrival;
+    Clock::time_point last_done;
+
+    void arrived(Clock::time_point t) {
+        std::lock_guard<std::mutex> lock(mu);
+        if (!started) {
+            started = true;
+            first_arrival = t;
+        }
+    }
+
+    void completed(double service_us, double queue_us, Clock::time_point done) {
+        std::lock_guard<std::mutex> lock(mu);
+        if (latencies_us.size() < kLatencyWindow) {
+            latencies_us.push_back(service_us);
+        } else {
+            latencies_us[requests % kLatencyWindow] = service_us;
+        }
+        ++requests;
+        queue_us_sum += queue_us;
+        last_done = done;
+    }
+
+    void batch_done() {
+        std::lock_guard<std::mutex> lock(mu);
+        ++batches;
+    }
+
+    chol::ServerStats snapshot() {
+        std::vector<double> sample;
+        chol::ServerStats out;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            sample = latencies_us;
+            out.requests = requests;
+            out.batches = batches;
+            if (batches > 0) {
+                out.mean_batch = static_cast<double>(requests) / static_cast<double>(batches);
+            }
+            if (requests > 0) {
+                out.mean_queue_us = queue_us_sum / static_cast<double>(requests);
+                double span_us = us_between(first_arrival, last_done);
+                out.throughput_rps = span_us > 0.0 ? requests / (span_us * 1e-6) : 0.0;
+            }
+        }
+        out.p50_us = chol::percentile(sample, 0.50);
+        out.p95_us = chol::percentile(sample, 0.95);
+        out.p99_us = chol::percentile(sample, 0.99);
+        return out;
+    }
+};
+
+// Completion count shared by the items of one dispatched batch.
+struct BatchState {
+    int size = 0;
+    std::atomic<int> remaining{0};
+};
+
+struct Job {
+    Pending item;
+    std::shared_ptr<BatchState> batch;
+};
+
+struct WorkerPool {
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<Job> queue;
+    bool closing = false;
+    std::vector<std::thread> threads;
+
+    // Items go in one by one, back to back: idle workers split the batch between
+    // them, and each keeps factoring same-size matrices while the batch lasts.
+    void submit(Batch&& batch) {
+        auto state = std::make_shared<BatchState>();
+        state->size = static_cast<int>(batch.items.size());
+        state->remaining = state->size;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            for (Pending& p : batch.items) {
+                queue.push_back({std::move(p), state});
+            }
+        }
+        cv.notify_all();
+    }
+};
+
+void serve(const Job& job, std::vector<double>& work, const Args& args, StatsLog& stats) {
+    const Pending& p = job.item;
+    const chol::Request& req = p.req;
+    chol::Response resp;
+    resp.id = req.id;
+    resp.batch = job.batch->size;
+    resp.queue_us = us_between(p.arrival, Clock::now());
+
+    const int n = req.n;
+    const int nrhs = req.op == chol::kOpSolve ? req.nrhs : 0;
+    const size_t a_elems = static_cast<size_t>(n) * n;
+    const size_t b_elems = static_cast<size_t>(n) * nrhs;
+    if (!p.conn->map || (a_elems + b_elems) * sizeof(double) > p.conn->map_bytes) {
+        resp.info = chol::kInfoShmError;
+    } else {
+        // Factor in the worker's own buffer: it is already faulted in and stays
+        // cache-resident across a batch of same-size matrices.
+        double* shm = static_cast<double*>(p.conn->map);
+        double* a = work.data();
+        double* b = a + a_elems;
+        std::memcpy(a, shm, a_elems * sizeof(double));
+        std::memcpy(b, shm + a_elems, b_elems * sizeof(double));
+        const int nb = std::min(args.nb, n);
+        double logdet = 0.0;
+        resp.info = chol::factor_fused(n, nb, a, n, nrhs, b, n, nullptr, &logdet);
+        if (resp.info == 0) {
+            if (nrhs > 0) {
+                chol::backward_solve(n, nb, a, n, nrhs, b, n);
+            }
+            std::memcpy(shm, a, (a_elems + b_elems) * sizeof(double));
+            resp.logdet = logdet;
+        }
+    }
+
+    Clock::time_point done = Clock::now();
+    resp.service_us = us_between(p.arrival, done);
+    stats.completed(resp.service_us, resp.queue_us, done);
+    if (job.batch->remaining.fetch_sub(1) == 1) {
+        stats.batch_done();
+    }
+    // The segment is no longer touched, so the connection may take its next request.
+    p.conn->busy = false;
+    p.conn->reply(&resp, sizeof(resp));
+}
+
+// Workers run the dense kernels single-threaded; parallelism comes from serving
+// independent requests, and the workspace is sized once for the largest request.
+void run_worker(WorkerPool& pool, const Args& args, StatsLog& stats) {
+    omp_set_num_threads(1);
+    std::vector<double> work(static_cast<size_t>(args.max_n) * args.max_n +
+                             static_cast<size_t>(args.max_n) * args.max_nrhs);
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(pool.mu);
+            pool.cv.wait(lock, [&] { return pool.closing || !pool.queue.empty(); });
+            if (pool.queue.empty()) {
+                return;
+            }
+            job = std::move(pool.queue.front());
+            pool.queue.pop_front();
+        }
+        CHOL_TRACE_SCOPE("request");
+        serve(job, work, args, stats);
+    }
+}
+
+int open_listener(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        int err = errno;
+        close(fd);
+        throw std::runtime_error(path + ": " + std::strerror(err));
+    }
+    return fd;
+}
+
+// Accept/poll loop on the main thread: reads requests, holds them in per-size
+// batches and hands due batches to the pool.
+struct Server {
+    const Args& args;
+    int listen_fd;
+    bool shutting_down = false;
+    WorkerPool pool;
+    StatsLog log;
+    std::vector<std::shared_ptr<Connection>> conns;
+    std::map<int, Batch> pending;
+
+    Server(const Args& args_in, int listen_fd_in) : args(args_in), listen_fd(listen_fd_in) {
+        for (int w = 0; w < args.workers; ++w) {
+            pool.threads.emplace_back(run_worker, std::ref(pool), std::cref(args),
+                                       std::ref(log));
+        }
+    }
+
+    void run() {
+        while (!g_stop && !shutting_down) {
+            poll_once();
+            flush(false);
+        }
+        flush(true);
+        {
+            std::lock_guard<std::mutex> lock(pool.mu);
+            pool.closing = true;
+        }
+        pool.cv.notify_all();
+        for (std::thread& t : pool.threads) {
+            t.join();
+        }
+        conns.clear();
+    }
+
+    // Sleeps until a socket is readable or the oldest held request reaches its window.
+    void poll_once() {
+        const Clock::time_point now = Clock::now();
+        Clock::duration wait = std::chrono::milliseconds(100);
+        for (const auto& kv : pending) {
+            Clock::time_point due = kv.second.items.front().arrival + window();
+            wait = std::min(wait, due > now ? due - now : Clock::duration::zero());
+        }
+        std::vector<pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (const auto& conn : conns) {
+            fds.push_back({conn->fd, POLLIN, 0});
+        }
+        const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count();
+        timespec ts = {static_cast<time_t>(ns / 1000000000LL), static_cast<long>(ns % 1000000000LL)};
+        if (ppoll(fds.data(), fds.size(), &ts, nullptr) <= 0) {
+            return;
+        }
+
+        std::vector<std::shared_ptr<Connection>> open;
+        for (size_t i = 1; i < fds.size(); ++i) {
+            const std::shared_ptr<Connection>& conn = conns[i - 1];
+            if (fds[i].revents == 0) {
+                open.push_back(conn);
+                continue;
+            }
+            // A single read per wake-up: a client with more queued bytes is polled
+            // readable again next round, after every other socket has had its turn.
+            chol::Request req;
+            bool closed = false;
+            if (conn->receive(req, &closed)) {
+                handle(conn, req);
+            }
+            if (!closed) {
+                open.push_back(conn);
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd >= 0) {
+                open.push_back(std::make_shared<Connection>(fd));
+            }
+        }
+        conns.swap(open);
+    }
+
+    void handle(const std::shared_ptr<Connection>& conn, chol::Request& req) {
+        if (req.op == chol::kOpStats) {
+            chol::ServerStats out = log.snapshot();
+            conn->reply(&out, sizeof(out));
+            return;
+        }
+        chol::Response resp;
+        resp.id = req.id;
+        if (req.op == chol::kOpShutdown) {
+            shutting_down = true;
+            conn->reply(&resp, sizeof(resp));
+            return;
+        }
+
+        // One factor/solve in flight per connection: the client owns the segment again
+        // only once it has the response, and attach() below may remap it.
+        if (conn->busy) {
+            resp.info = chol::kInfoBusy;
+            conn->reply(&resp, sizeof(resp));
+            return;
+        }
+        req.shm_name[sizeof(req.shm_name) - 1] = '\0';
+        const bool valid = (req.op == chol::kOpFactor || req.op == chol::kOpSolve) && req.n > 0 &&
+                           req.n <= args.max_n &&
+                           (req.op == chol::kOpFactor || (req.nrhs > 0 && req.nrhs <= args.max_nrhs));
+        if (!valid || !conn->attach(req.shm_name)) {
+            resp.info = valid ? chol::kInfoShmError : chol::kInfoBadRequest;
+            conn->reply(&resp, sizeof(resp));
+            return;
+        }
+        conn->busy = true;
+
+        const Clock::time_point now = Clock::now();
+        log.arrived(now);
+        Batch& batch = pending[req.n];
+        batch.n = req.n;
+        batch.items.push_back({conn, req, now});
+        if (static_cast<int>(batch.items.size()) >= args.max_batch) {
+            pool.submit(std::move(batch));
+            pending.erase(req.n);
+        }
+    }
+
+    // Hands every batch whose oldest request has waited a full window to the pool.
+    void flush(bool all) {
+        const Clock::time_point now = Clock::now();
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (all || now - it->second.items.front().arrival >= window()) {
+                pool.submit(std::move(it->second));
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    Clock::duration window() const {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(args.window_us));
+    }
+};
+}  // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    try {
+        args = parse_args(argc, argv);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Argument error: %s\n", ex.what());
+        return 1;
+    }
+    if (!args.trace_path.empty()) {
+        chol_trace_enable();
+    }
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    int listen_fd = -1;
+    try {
+        listen_fd = open_listener(args.socket_path);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Server error: %s\n", ex.what());
+        return 1;
+    }
+    std::fprintf(stderr, "chol_server listening on %s with %d workers\n", args.socket_path.c_str(),
+                 args.workers);
+
+    const Clock::time_point start = Clock::now();
+    Server server(args, listen_fd);
+    server.run();
+    close(listen_fd);
+    unlink(args.socket_path.c_str());
+    const double uptime_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    chol::ServerStats st = server.log.snapshot();
+    std::printf(
+        "{\"method\":\"chol_server\",\"workers\":%d,\"window_us\":%d,\"max_batch\":%d,"
+        "\"requests\":%llu,\"batches\":%llu,\"mean_batch\":%.3f,\"throughput_rps\":%.3f,"
+        "\"mean_queue_us\":%.3f,\"p50_us\":%.3f,\"p95_us\":%.3f,\"p99_us\":%.3f,"
+        "\"uptime_ms\":%.3f",
+        args.workers, args.window_us, args.max_batch, static_cast<unsigned long long>(st.requests),
+        static_cast<unsigned long long>(st.batches), st.mean_batch, st.throughput_rps,
+        st.mean_queue_us, st.p50_us, st.p95_us, st.p99_us, uptime_ms);
+    if (!args.trace_path.empty()) {
+        if (chol_trace_dump(args.trace_path.c_str(), "chol_server") != 0) {
+            std::fprintf(stderr, "Failed to write trace %s\n", args.trace_path.c_str());
+        }
+        chol_trace_report(stdout, uptime_ms);
+    }
+    std::printf("}\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Wire protocol shared by chol_server and chol_client. Every message is one
+// fixed-size struct on a Unix stream socket; matrix data never goes through the
+// socket. The client owns a POSIX shared-memory segment laid out as
+//
+//   A: n x n, column-major, lower triangle used (overwritten with L)
+//   B: n x nrhs, column-major, directly after A (overwritten with A^-1 * B)
+//
+// and sends one request at a time per connection, waiting for its response
+// before touching the segment again.
+namespace chol {
+
+constexpr const char* kDefaultSocketPath = "/tmp/chol_server.sock";
+
+enum ServerOp : uint32_t {
+    kOpFactor = 1,    // A = L * L^T
+    kOpSolve = 2,     // A = L * L^T, then B = A^-1 * B
+    kOpStats = 3,     // reply is a ServerStats instead of a Response
+    kOpShutdown = 4,  // finish queued work, then exit
+};
+
+struct Request {
+    uint64_t id = 0;
+    uint32_t op = kOpFactor;
+    int32_t n = 0;
+    int32_t nrhs = 0;
+    char shm_name[64] = {0};
+};
+
+// info: 0 on success, the 1-based column of a non-positive pivot, or one of the
+// negative codes below.
+constexpr int32_t kInfoBadRequest = -1;
+constexpr int32_t kInfoShmError = -2;
+constexpr int32_t kInfoBusy = -3;  // the connection already has a request in flight
+
+struct Response {
+    uint64_t id = 0;
+    int32_t info = 0;
+    int32_t batch = 0;        // size of the same-size batch the request ran in
+    double logdet = 0.0;
+    double queue_us = 0.0;    // arrival until a worker picked up the request
+    double service_us = 0.0;  // arrival until the response was sent
+};
+
+struct ServerStats {
+    uint64_t requests = 0;
+    uint64_t batches = 0;
+    double mean_batch = 0.0;
+    double throughput_rps = 0.0;
+    double mean_queue_us = 0.0;
+    double p50_us = 0.0;
+    double p95_us = 0.0;
+    double p99_us = 0.0;
+};
+
+inline bool read_full(int fd, void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        ssize_t got = recv(fd, p, len, 0);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        p += got;
+        len -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+inline bool write_full(int fd, const void* buf, size_t len) {
+    const char* p = static_cast<const char*>(buf);
+    while (len > 0) {
+        ssize_t put = send(fd, p, len, MSG_NOSIGNAL);
+        if (put < 0 && errno == EINTR) {
+            continue;
+        }
+        if (put <= 0) {
+            return false;
+        }
+        p += put;
+        len -= static_cast<size_t>(put);
+    }
+    return true;
+}
+
+// Nearest-rank percentile (p in [0, 1]) of an unsorted sample; 0 when empty.
+inline double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(values.size())));
+    rank = std::min(std::max<size_t>(rank, 1), values.size()) - 1;
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+}  // namespace chol
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cmath>
+
+// Single-threaded column-major tile kernels shared by the CPU drivers.
+// All routines work on the lower triangle and follow LAPACK argument order.
+namespace chol {
+
+// A = L * L^T in place. Returns 0 on success or the 1-based column of the
+// first non-positive pivot, like LAPACK's info.
+inline int potrf_lower(int n, double* a, int lda) {
+    for (int j = 0; j < n; ++j) {
+        double* col = a + static_cast<size_t>(j) * lda;
+        double d = col[j];
+        if (!(d > 0.0)) {
+            return j + 1;
+        }
+        d = std::sqrt(d);
+        col[j] = d;
+        const double inv = 1.0 / d;
+        for (int i = j + 1; i < n; ++i) {
+            col[i] *= inv;
+        }
+        for (int c = j + 1; c < n; ++c) {
+            double* dst = a + static_cast<size_t>(c) * lda;
+            const double t = col[c];
+            for (int i = c; i < n; ++i) {
+                dst[i] -= col[i] * t;
+            }
+        }
+    }
+    return 0;
+}
+
+// B = B * L^-T, with B m x n and L n x n lower triangular.
+inline void trsm_right_lower_trans(int m, int n, const double* l, int ldl, double* b, int ldb) {
+    for (int j = 0; j < n; ++j) {
+        double* bj = b + static_cast<size_t>(j) * ldb;
+        for (int k = 0; k < j; ++k) {
+            const double t = l[j + static_cast<size_t>(k) * ldl];
+            const double* bk = b + static_cast<size_t>(k) * ldb;
+            for (int i = 0; i < m; ++i) {
+                bj[i] -= bk[i] * t;
+            }
+        }
+        const double inv = 1.0 / l[j + static_cast<size_t>(j) * ldl];
+        for (int i = 0; i < m; ++i) {
+            bj[i] *= inv;
+        }
+    }
+}
+
+// C -= A * A^T on the lower triangle, with C n x n and A n x k.
+inline void syrk_lower_sub(int n, int k, const double* a, int lda, double* c, int ldc) {
+    for (int j = 0; j < n; ++j) {
+        double* cj = c + static_cast<size_t>(j) * ldc;
+        for (int p = 0; p < k; ++p) {
+            const double* ap = a + static_cast<size_t>(p) * lda;
+            const double t = ap[j];
+            for (int i = j; i < n; ++i) {
+                cj[i] -= ap[i] * t;
+            }
+        }
+    }
+}
+
+// C -= A * B^T, with C m x n, A m x k and B n x k.
+inline void gemm_nt_sub(int m, int n, int k, const double* a, int lda, const double* b, int ldb,
+                        double* c, int ldc) {
+    for (int j = 0; j < n; ++j) {
+        double* cj = c + static_cast<size_t>(j) * ldc;
+        for (int p = 0; p < k; ++p) {
+            const double* ap = a + static_cast<size_t>(p) * lda;
+            const double t = b[j + static_cast<size_t>(p) * ldb];
+            for (int i = 0; i < m; ++i) {
+                cj[i] -= ap[i] * t;
+            }
+        }
+    }
+}
+
+// Solves L * X = B in place, with L m x m lower triangular and B m x n.
+inline void trsm_left_lower(int m, int n, const double* l, int ldl, double* b, int ldb) {
+    for (int j = 0; j < n; ++j) {
+        double* bj = b + static_cast<size_t>(j) * ldb;
+        for (int k = 0; k < m; ++k) {
+            const double* lk = l + static_cast<size_t>(k) * ldl;
+            const double t = bj[k] / lk[k];
+            bj[k] = t;
+            for (int i = k + 1; i < m; ++i) {
+                bj[i] -= lk[i] * t;
+            }
+        }
+    }
+}
+
+// Solves L^T * X = B in place, with L m x m lower triangular and B m x n.
+inline void trsm_left_lower_trans(int m, int n, const double* l, int ldl, double* b, int ldb) {
+    for (int j = 0; j < n; ++j) {
+        double* bj = b + static_cast<size_t>(j) * ldb;
+        for (int k = m - 1; k >= 0; --k) {
+            const double* lk = l + static_cast<size_t>(k) * ldl;
+            double t = bj[k];
+            for (int i = k + 1; i < m; ++i) {
+                t -= lk[i] * bj[i];
+            }
+            bj[k] = t / lk[k];
+        }
+    }
+}
+
+// C -= A * B, with C m x n, A m x k and B k x n.
+inline void gemm_nn_sub(int m, int n, int k, const double* a, int lda, const double* b, int ldb,
+                        double* c, int ldc) {
+    for (int j = 0; j < n; ++j) {
+        double* cj = c + static_cast<size_t>(j) * ldc;
+        const double* bj = b + static_cast<size_t>(j) * ldb;
+        for (int p = 0; p < k; ++p) {
+            const double* ap = a + static_cast<size_t>(p) * lda;
+            const double t = bj[p];
+            for (int i = 0; i < m; ++i) {
+                cj[i] -= ap[i] * t;
+            }
+        }
+    }
+}
+
+// C -= A^T * B, with C m x n, A k x m and B k x n.
+inline void gemm_tn_sub(int m, int n, int k, const double* a, int lda, const double* b, int ldb,
+                        double* c, int ldc) {
+    for (int j = 0; j < n; ++j) {
+        double* cj = c + static_cast<size_t>(j) * ldc;
+        const double* bj = b + static_cast<size_t>(j) * ldb;
+        for (int i = 0; i < m; ++i) {
+            const double* ai = a + static_cast<size_t>(i) * lda;
+            double t = 0.0;
+            for (int p = 0; p < k; ++p) {
+                t += ai[p] * bj[p];
+            }
+            cj[i] -= t;
+        }
+    }
+}
+
+}  // namespace chol
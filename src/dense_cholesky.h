@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "cpu_kernels.h"
+#include "trace.h"
+
+// Blocked, OpenMP-parallel dense Cholesky routines on column-major lower storage,
+// built from the tile kernels in cpu_kernels.h.
+//
+// Right-hand sides may carry a first_row[] array (non-decreasing across columns):
+// rows above first_row[c] of column c are known to be zero, which is what makes
+// solving against unit vectors (selected columns of the inverse) cheaper than a
+// dense solve. A null first_row means every column is dense.
+namespace chol {
+
+// Number of leading right-hand sides that are non-zero somewhere above row_end.
+inline int active_rhs(int nrhs, const int* first_row, int row_end) {
+    if (!first_row) {
+        return nrhs;
+    }
+    return static_cast<int>(std::lower_bound(first_row, first_row + nrhs, row_end) - first_row);
+}
+
+// A = L * L^T in place. During the same sweep over A it also overwrites B with
+// L^-1 * B and adds log det(A) to *logdet (when non-null), so neither needs a second
+// pass over L. Returns 0 or the 1-based column of the first non-positive pivot.
+//
+// With split_ms non-null, columns from split_rhs on are solved in their own loop at
+// each step instead of sharing tasks with A, and the wall time of that loop is added
+// to *split_ms, so a caller can price those columns without a second factorization.
+inline int factor_fused(int n, int nb, double* a, int lda, int nrhs, double* b, int ldb,
+                        const int* first_row, double* logdet, int split_rhs = 0,
+                        double* split_ms = nullptr) {
+    const int split = split_ms ? std::min(std::max(split_rhs, 0), nrhs) : nrhs;
+    std::vector<std::array<int, 2>> tasks;
+    for (int k0 = 0; k0 < n; k0 += nb) {
+        const int kb = std::min(nb, n - k0);
+        double* akk = a + k0 + static_cast<size_t>(k0) * lda;
+        int info = 0;
+        {
+            CHOL_TRACE_SCOPE("potrf");
+            info = potrf_lower(kb, akk, lda);
+        }
+        if (info != 0) {
+            return k0 + info;
+        }
+        if (logdet) {
+            double sum = 0.0;
+            for (int i = 0; i < kb; ++i) {
+                sum += std::log(akk[i + static_cast<size_t>(i) * lda]);
+            }
+            *logdet += 2.0 * sum;
+        }
+
+        const int r0 = k0 + kb;
+        const int nrb = (n - r0 + nb - 1) / nb;
+        const int nactive = active_rhs(nrhs, first_row, r0);
+        const int ncols = std::min(nactive, split);
+        const int ncb = (ncols + nb - 1) / nb;
+
+        // Panel below the diagonal block and the matching rows of B both need only L_kk.
+#pragma omp parallel for schedule(dynamic)
+        for (int t = 0; t < nrb + ncb; ++t) {
+            if (t < nrb) {
+                CHOL_TRACE_SCOPE("trsm");
+                const int i0 = r0 + t * nb;
+                trsm_right_lower_trans(std::min(nb, n - i0), kb, akk, lda,
+                                       a + i0 + static_cast<size_t>(k0) * lda, lda);
+            } else {
+                CHOL_TRACE_SCOPE("forward");
+                const int c0 = (t - nrb) * nb;
+                trsm_left_lower(kb, std::min(nb, ncols - c0), akk, lda,
+                                b + k0 + static_cast<size_t>(c0) * ldb, ldb);
+            }
+        }
+
+        // Trailing update: (i, j) lower blocks of A, then (i, c) blocks of B with j = -1 - c.
+        tasks.clear();
+        for (int j = 0; j < nrb; ++j) {
+            for (int i = j; i < nrb; ++i) {
+                tasks.push_back({i, j});
+            }
+        }
+        for (int c = 0; c < ncb; ++c) {
+            for (int i = 0; i < nrb; ++i) {
+                tasks.push_back({i, -1 - c});
+            }
+        }
+#pragma omp parallel for schedule(dynamic)
+        for (size_t t = 0; t < tasks.size(); ++t) {
+            const int i0 = r0 + tasks[t][0] * nb;
+            const int im = std::min(nb, n - i0);
+            const double* lik = a + i0 + static_cast<size_t>(k0) * lda;
+            if (tasks[t][1] >= 0) {
+                const int j0 = r0 + tasks[t][1] * nb;
+                const int jn = std::min(nb, n - j0);
+                const double* ljk = a + j0 + static_cast<size_t>(k0) * lda;
+                double* aij = a + i0 + static_cast<size_t>(j0) * lda;
+                if (i0 == j0) {
+                    CHOL_TRACE_SCOPE("syrk");
+                    syrk_lower_sub(jn, kb, ljk, lda, aij, lda);
+                } else {
+                    CHOL_TRACE_SCOPE("gemm");
+                    gemm_nt_sub(im, jn, kb, lik, lda, ljk, lda, aij, lda);
+                }
+            } else {
+                CHOL_TRACE_SCOPE("forward_update");
+                const int c0 = (-1 - tasks[t][1]) * nb;
+                const int cn = std::min(nb, ncols - c0);
+                gemm_nn_sub(im, cn, kb, lik, lda, b + k0 + static_cast<size_t>(c0) * ldb, ldb,
+                            b + i0 + static_cast<size_t>(c0) * ldb, ldb);
+            }
+        }
+
+        // Split-off columns: block k of each column block, then every row below it.
+        if (nactive > split) {
+            const int nsb = (nactive - split + nb - 1) / nb;
+            auto s0 = std::chrono::steady_clock::now();
+#pragma omp parallel for schedule(dynamic)
+            for (int c = 0; c < nsb; ++c) {
+                CHOL_TRACE_SCOPE("forward_split");
+                const int c0 = split + c * nb;
+                const int cn = std::min(nb, nactive - c0);
+                double* bk = b + k0 + static_cast<size_t>(c0) * ldb;
+                trsm_left_lower(kb, cn, akk, lda, bk, ldb);
+                if (r0 < n) {
+                    gemm_nn_sub(n - r0, cn, kb, a + r0 + static_cast<size_t>(k0) * lda, lda, bk,
+                                ldb, b + r0 + static_cast<size_t>(c0) * ldb, ldb);
+                }
+            }
+            auto s1 = std::chrono::steady_clock::now();
+            *split_ms += std::chrono::duration<double, std::milli>(s1 - s0).count();
+        }
+    }
+    return 0;
+}
+
+inline int factor(int n, int nb, double* a, int lda) {
+    return factor_fused(n, nb, a, lda, 0, nullptr, 1, nullptr, nullptr);
+}
+
+// B = L^-1 * B as a separate pass over an existing factor.
+inline void forward_solve(int n, int nb, const double* l, int ldl, int nrhs, double* b, int ldb,
+                          const int* first_row) {
+    for (int k0 = 0; k0 < n; k0 += nb) {
+        const int kb = std::min(nb, n - k0);
+        const int r0 = k0 + kb;
+        const int ncols = active_rhs(nrhs, first_row, r0);
+        const int ncb = (ncols + nb - 1) / nb;
+        const double* lkk = l + k0 + static_cast<size_t>(k0) * ldl;
+#pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < ncb; ++c) {
+            const int c0 = c * nb;
+            const int cn = std::min(nb, ncols - c0);
+            double* bk = b + k0 + static_cast<size_t>(c0) * ldb;
+            trsm_left_lower(kb, cn, lkk, ldl, bk, ldb);
+            if (r0 < n) {
+                gemm_nn_sub(n - r0, cn, kb, l + r0 + static_cast<size_t>(k0) * ldl, ldl, bk, ldb,
+                            b + r0 + static_cast<size_t>(c0) * ldb, ldb);
+            }
+        }
+    }
+}
+
+// B = L^-T * B, the second half of a solve with A.
+inline void backward_solve(int n, int nb, const double* l, int ldl, int nrhs, double* b, int ldb) {
+    const int nblocks = (n + nb - 1) / nb;
+    const int ncb = (nrhs + nb - 1) / nb;
+    for (int kblk = nblocks - 1; kblk >= 0; --kblk) {
+        const int k0 = kblk * nb;
+        const int kb = std::min(nb, n - k0);
+        const int r0 = k0 + kb;
+        const double* lkk = l + k0 + static_cast<size_t>(k0) * ldl;
+#pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < ncb; ++c) {
+            const int c0 = c * nb;
+            const int cn = std::min(nb, nrhs - c0);
+            double* bk = b + k0 + static_cast<size_t>(c0) * ldb;
+            if (r0 < n) {
+                gemm_tn_sub(kb, cn, n - r0, l + r0 + static_cast<size_t>(k0) * ldl, ldl,
+                            b + r0 + static_cast<size_t>(c0) * ldb, ldb, bk, ldb);
+            }
+            trsm_left_lower_trans(kb, cn, lkk, ldl, bk, ldb);
+        }
+    }
+}
+
+}  // namespace chol
@@ -0,0 +1,553 @@
+#ifdef GEMM_WITH_HIP
+#include <hip/hip_runtime.h>
+#include <rocblas/rocblas.h>
+#endif
+#include <omp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+// C = A * B in double precision, column-major, for the shapes that dominate the
+// Cholesky trailing update. Every variant is checked against exact dot products.
+// naive/tiled/packed/hip are the hand-written kernels; blas (the Fortran dgemm_ that
+// ScaLAPACK links) and rocblas are the vendor libraries the solvers actually run on.
+// --calibrate, which takes one of the vendor variants, also measures STREAM triad
+// bandwidth and prints the pair of rates that run_bench uses for its roofline model.
+namespace {
+struct Args {
+    int m = 1024;
+    int n = 1024;
+    int k = 1024;
+    int iters = 3;
+    std::string variant = "packed";
+    bool calibrate = false;
+    int stream_mb = 256;
+    std::string trace_path;
+};
+
+Args parse_args(int argc, char** argv) {
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--m") == 0 && i + 1 < argc) {
+            args.m = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            args.n = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--k") == 0 && i + 1 < argc) {
+            args.k = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            args.iters = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--variant") == 0 && i + 1 < argc) {
+            args.variant = argv[++i];
+        } else if (std::strcmp(argv[i], "--calibrate") == 0) {
+            args.calibrate = true;
+        } else if (std::strcmp(argv[i], "--stream-mb") == 0 && i + 1 < argc) {
+            args.stream_mb = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            args.trace_path = argv[++i];
+        }
+    }
+    if (args.calibrate &&
+        ((args.variant != "blas" && args.variant != "rocblas") || args.stream_mb <= 0)) {
+        throw std::runtime_error(
+            "--calibrate needs --variant blas or rocblas and a positive --stream-mb");
+    }
+    if (args.m <= 0 || args.n <= 0 || args.k <= 0 || args.iters <= 0) {
+        throw std::runtime_error("--m, --n, --k and --iters must be positive");
+    }
+    return args;
+}
+
+// One output per loop iteration, the CPU analogue of one thread per output.
+void gemm_naive(int m, int n, int k, const double* a, const double* b, double* c) {
+#pragma omp parallel for schedule(static)
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < m; ++i) {
+            double sum = 0.0;
+            for (int p = 0; p < k; ++p) {
+                sum += a[i + static_cast<size_t>(p) * m] * b[p + static_cast<size_t>(j) * k];
+            }
+            c[i + static_cast<size_t>(j) * m] = sum;
+        }
+    }
+}
+
+// Cache blocking only: the inner loop streams a column of A into a column of C.
+void gemm_tiled(int m, int n, int k, const double* a, const double* b, double* c) {
+    constexpr int TM = 128;
+    constexpr int TN = 64;
+    constexpr int TK = 256;
+    std::fill(c, c + static_cast<size_t>(m) * n, 0.0);
+#pragma omp parallel for schedule(static)
+    for (int jj = 0; jj < n; jj += TN) {
+        const int je = std::min(n, jj + TN);
+        for (int pp = 0; pp < k; pp += TK) {
+            const int pe = std::min(k, pp + TK);
+            for (int ii = 0; ii < m; ii += TM) {
+                const int ie = std::min(m, ii + TM);
+                for (int j = jj; j < je; ++j) {
+                    double* cj = c + static_cast<size_t>(j) * m;
+                    for (int p = pp; p < pe; ++p) {
+                        const double t = b[p + static_cast<size_t>(j) * k];
+                        const double* ap = a + static_cast<size_t>(p) * m;
+                        for (int i = ii; i < ie; ++i) {
+                            cj[i] += ap[i] * t;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Packed panels and an MR x NR register block, in the GotoBLAS loop order.
+constexpr int MR = 8;
+constexpr int NR = 4;
+constexpr int MC = 128;
+constexpr int KC = 256;
+constexpr int NC = 2048;
+
+void pack_a(int mc, int kc, const double* a, int lda, double* buf) {
+    for (int ir = 0; ir < mc; ir += MR) {
+        const int mr = std::min(MR, mc - ir);
+        for (int p = 0; p < kc; ++p) {
+            const double* src = a + ir + static_cast<size_t>(p) * lda;
+            for (int r = 0; r < MR; ++r) {
+                *buf++ = r < mr ? src[r] : 0.0;
+            }
+        }
+    }
+}
+
+void pack_b(int kc, int nc, const double* b, int ldb, double* buf) {
+    for (int jr = 0; jr < nc; jr += NR) {
+        const int nr = std::min(NR, nc - jr);
+        for (int p = 0; p < kc; ++p) {
+            for (int r = 0; r < NR; ++r) {
+                *buf++ = r < nr ? b[p + static_cast<size_t>(jr + r) * ldb] : 0.0;
+            }
+        }
+    }
+}
+
+void micro_kernel(int kc, const double* a, const double* b, double* c, int ldc, int mr, int nr) {
+    double acc[NR][MR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int j = 0; j < NR; ++j) {
+            const double t = b[j];
+            for (int i = 0; i < MR; ++i) {
+                acc[j][i] += a[i] * t;
+            }
+        }
+        a += MR;
+        b += NR;
+    }
+    for (int j = 0; j < nr; ++j) {
+        double* cj = c + static_cast<size_t>(j) * ldc;
+        for (int i = 0; i < mr; ++i) {
+            cj[i] += acc[j][i];
+        }
+    }
+}
+
+void gemm_packed(int m, int n, int k, const double* a, const double* b, double* c) {
+    std::fill(c, c + static_cast<size_t>(m) * n, 0.0);
+    const int nc_max = std::min(NC, n);
+    std::vector<double> bpack(static_cast<size_t>(std::min(KC, k)) * (nc_max + NR));
+    for (int jc = 0; jc < n; jc += NC) {
+        const int nc = std::min(NC, n - jc);
+        for (int pc = 0; pc < k; pc += KC) {
+            const int kc = std::min(KC, k - pc);
+            pack_b(kc, nc, b + pc + static_cast<size_t>(jc) * k, k, bpack.data());
+#pragma omp parallel
+            {
+                std::vector<double> apack(static_cast<size_t>(MC + MR) * kc);
+#pragma omp for schedule(dynamic)
+                for (int ic = 0; ic < m; ic += MC) {
+                    const int mc = std::min(MC, m - ic);
+                    pack_a(mc, kc, a + ic + static_cast<size_t>(pc) * m, m, apack.data());
+                    for (int jr = 0; jr < nc; jr += NR) {
+                        const double* bp = bpack.data() + static_cast<size_t>(jr) * kc;
+                        for (int ir = 0; ir < mc; ir += MR) {
+                            micro_kernel(kc, apack.data() + static_cast<size_t>(ir) * kc, bp,
+                                         c + ic + ir + static_cast<size_t>(jc + jr) * m, m,
+                                         std::min(MR, mc - ir), std::min(NR, nc - jr));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+#ifdef GEMM_WITH_HIP
+constexpr int HIP_TILE = 16;
+
+__global__ void gemm_tiled_kernel(int m, int n, int k, const double* a, const double* b,
+                                  double* c) {
+    __shared__ double as[HIP_TILE][HIP_TILE];
+    __shared__ double bs[HIP_TILE][HIP_TILE];
+    const int row = blockIdx.x * HIP_TILE + threadIdx.x;
+    const int col = blockIdx.y * HIP_TILE + threadIdx.y;
+    double sum = 0.0;
+    for (int p0 = 0; p0 < k; p0 += HIP_TILE) {
+        const int pa = p0 + threadIdx.y;
+        const int pb = p0 + threadIdx.x;
+        as[threadIdx.y][threadIdx.x] =
+            (row < m && pa < k) ? a[row + static_cast<size_t>(pa) * m] : 0.0;
+        bs[threadIdx.y][threadIdx.x] =
+            (col < n && pb < k) ? b[pb + static_cast<size_t>(col) * k] : 0.0;
+        __syncthreads();
+        for (int p = 0; p < HIP_TILE; ++p) {
+            sum += as[p][threadIdx.x] * bs[threadIdx.y][p];
+        }
+        __syncthreads();
+    }
+    if (row < m && col < n) {
+        c[row + static_cast<size_t>(col) * m] = sum;
+    }
+}
+
+void check_hip(hipError_t status, const char* msg) {
+    if (status != hipSuccess) {
+        throw std::runtime_error(std::string(msg) + ": " + hipGetErrorString(status));
+    }
+}
+
+void check_rocblas(rocblas_status status, const char* msg) {
+    if (status != rocblas_status_success) {
+        throw std::runtime_error(std::string(msg) + ": rocblas error");
+    }
+}
+
+// Kernel time only; the operands are copied to the device once up front, and one
+// untimed call absorbs rocBLAS kernel loading.
+double run_hip(const Args& args, bool use_rocblas, const std::vector<double>& hA,
+               const std::vector<double>& hB, std::vector<double>& hC) {
+    const int m = args.m, n = args.n, k = args.k;
+    double *dA = nullptr, *dB = nullptr, *dC = nullptr;
+    check_hip(hipMalloc(&dA, hA.size() * sizeof(double)), "hipMalloc dA");
+    check_hip(hipMalloc(&dB, hB.size() * sizeof(double)), "hipMalloc dB");
+    check_hip(hipMalloc(&dC, hC.size() * sizeof(double)), "hipMalloc dC");
+    check_hip(hipMemcpy(dA, hA.data(), hA.size() * sizeof(double), hipMemcpyHostToDevice),
+              "hipMemcpy H2D A");
+    check_hip(hipMemcpy(dB, hB.data(), hB.size() * sizeof(double), hipMemcpyHostToDevice),
+              "hipMemcpy H2D B");
+
+    rocblas_handle handle = nullptr;
+    if (use_rocblas) {
+        check_rocblas(rocblas_create_handle(&handle), "rocblas_create_handle");
+    }
+    dim3 block(HIP_TILE, HIP_TILE);
+    dim3 grid((m + HIP_TILE - 1) / HIP_TILE, (n + HIP_TILE - 1) / HIP_TILE);
+    const double one = 1.0, zero = 0.0;
+    auto launch = [&] {
+        if (use_rocblas) {
+            check_rocblas(rocblas_dgemm(handle, rocblas_operation_none, rocblas_operation_none, m,
+                                        n, k, &one, dA, m, dB, k, &zero, dC, m),
+                          "rocblas_dgemm");
+        } else {
+            hipLaunchKernelGGL(gemm_tiled_kernel, grid, block, 0, nullptr, m, n, k, dA, dB, dC);
+            check_hip(hipGetLastError(), "gemm_tiled_kernel");
+        }
+    };
+    launch();
+    check_hip(hipDeviceSynchronize(), "hipDeviceSynchronize");
+
+    hipEvent_t start, stop;
+    check_hip(hipEventCreate(&start), "hipEventCreate start");
+    check_hip(hipEventCreate(&stop), "hipEventCreate stop");
+    double total_ms = 0.0;
+    for (int iter = 0; iter < args.iters; ++iter) {
+        CHOL_TRACE_SCOPE(use_rocblas ? "gemm_rocblas" : "gemm_hip");
+        check_hip(hipEventRecord(start, nullptr), "hipEventRecord start");
+        launch();
+        check_hip(hipEventRecord(stop, nullptr), "hipEventRecord stop");
+        check_hip(hipEventSynchronize(stop), "hipEventSynchronize stop");
+        float elapsed = 0.0f;
+        check_hip(hipEventElapsedTime(&elapsed, start, stop), "hipEventElapsedTime");
+        total_ms += static_cast<double>(elapsed);
+    }
+    check_hip(hipMemcpy(hC.data(), dC, hC.size() * sizeof(double), hipMemcpyDeviceToHost),
+              "hipMemcpy D2H C");
+
+    hipEventDestroy(start);
+    hipEventDestroy(stop);
+    if (handle) {
+        rocblas_destroy_handle(handle);
+    }
+    hipFree(dC);
+    hipFree(dB);
+    hipFree(dA);
+    return total_ms / static_cast<double>(args.iters);
+}
+
+__global__ void triad_kernel(size_t elems, double* a, const double* b, const double* c) {
+    size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (i < elems) {
+        a[i] = b[i] + 3.0 * c[i];
+    }
+}
+
+// Best-of-iters device triad bandwidth in GB/s.
+double stream_hip(size_t elems, int iters) {
+    double *a = nullptr, *b = nullptr, *c = nullptr;
+    check_hip(hipMalloc(&a, elems * sizeof(double)), "hipMalloc a");
+    check_hip(hipMalloc(&b, elems * sizeof(double)), "hipMalloc b");
+    check_hip(hipMalloc(&c, elems * sizeof(double)), "hipMalloc c");
+    check_hip(hipMemset(b, 0, elems * sizeof(double)), "hipMemset b");
+    check_hip(hipMemset(c, 0, elems * sizeof(double)), "hipMemset c");
+    hipEvent_t start, stop;
+    check_hip(hipEventCreate(&start), "hipEventCreate start");
+    check_hip(hipEventCreate(&stop), "hipEventCreate stop");
+    const unsigned threads = 256;
+    const unsigned blocks = static_cast<unsigned>((elems + threads - 1) / threads);
+    float best = 0.0f;
+    for (int iter = 0; iter < iters + 1; ++iter) {
+        check_hip(hipEventRecord(start, nullptr), "hipEventRecord start");
+        hipLaunchKernelGGL(triad_kernel, dim3(blocks), dim3(threads), 0, nullptr, elems, a, b, c);
+        check_hip(hipGetLastError(), "triad_kernel");
+        check_hip(hipEventRecord(stop, nullptr), "hipEventRecord stop");
+        check_hip(hipEventSynchronize(stop), "hipEventSynchronize stop");
+        float elapsed = 0.0f;
+        check_hip(hipEventElapsedTime(&elapsed, start, stop), "hipEventElapsedTime");
+        // The first launch is a warm-up.
+        if (iter > 0 && (best == 0.0f || elapsed < best)) {
+            best = elapsed;
+        }
+    }
+    hipEventDestroy(start);
+    hipEventDestroy(stop);
+    hipFree(c);
+    hipFree(b);
+    hipFree(a);
+    return 3.0 * sizeof(double) * static_cast<double>(elems) / (best * 1e6);
+}
+#endif
+
+// Best-of-iters host triad a = b + s * c in GB/s; arrays are first touched by the
+// threads that stream them.
+double stream_cpu(size_t elems, int iters) {
+    std::unique_ptr<double[]> a(new double[elems]);
+    std::unique_ptr<double[]> b(new double[elems]);
+    std::unique_ptr<double[]> c(new double[elems]);
+    const long long count = static_cast<long long>(elems);
+#pragma omp parallel for schedule(static)
+    for (long long i = 0; i < count; ++i) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+    double best = 0.0;
+    for (int iter = 0; iter < iters; ++iter) {
+        auto start = std::chrono::steady_clock::now();
+#pragma omp parallel for schedule(static)
+        for (long long i = 0; i < count; ++i) {
+            a[i] = b[i] + 3.0 * c[i];
+        }
+        auto stop = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+        if (best == 0.0 || ms < best) {
+            best = ms;
+        }
+    }
+    if (a[count / 2] != 7.0) {
+        throw std::runtime_error("stream triad produced a wrong result");
+    }
+    return 3.0 * sizeof(double) * static_cast<double>(elems) / (best * 1e6);
+}
+
+// Max relative error over a sample of entries (all of them for small C), each
+// recomputed as an exact dot product.
+double check_result(int m, int n, int k, const double* a, const double* b, const double* c) {
+    const size_t total = static_cast<size_t>(m) * n;
+    const size_t samples = std::min<size_t>(total, 4096);
+    std::mt19937_64 rng(42);
+    double max_err = 0.0;
+    for (size_t s = 0; s < samples; ++s) {
+        size_t idx = samples == total ? s : rng() % total;
+        int i = static_cast<int>(idx % m);
+        int j = static_cast<int>(idx / m);
+        double ref = 0.0;
+        double scale = 0.0;
+        for (int p = 0; p < k; ++p) {
+            double t = a[i + static_cast<size_t>(p) * m] * b[p + static_cast<size_t>(j) * k];
+            ref += t;
+            scale += std::fabs(t);
+        }
+        double err = std::fabs(c[idx] - ref) / (scale > 0.0 ? scale : 1.0);
+        max_err = std::max(max_err, err);
+    }
+    return max_err;
+}
+
+#ifdef GEMM_WITH_BLAS
+extern "C" void dgemm_(const char* transa, const char* transb, const int* m, const int* n,
+                       const int* k, const double* alpha, const double* a, const int* lda,
+                       const double* b, const int* ldb, const double* beta, double* c,
+                       const int* ldc);
+
+void gemm_blas(int m, int n, int k, const double* a, const double* b, double* c) {
+    const double one = 1.0, zero = 0.0;
+    dgemm_("N", "N", &m, &n, &k, &one, a, &m, b, &k, &zero, c, &m);
+}
+#endif
+
+double run_cpu(const Args& args, const std::string& variant, const std::vector<double>& hA,
+               const std::vector<double>& hB, std::vector<double>& hC) {
+    void (*fn)(int, int, int, const double*, const double*, double*) = nullptr;
+    [[maybe_unused]] const char* span = nullptr;
+    if (variant == "naive") {
+        fn = gemm_naive;
+        span = "gemm_naive";
+    } else if (variant == "tiled") {
+        fn = gemm_tiled;
+        span = "gemm_tiled";
+    } else if (variant == "packed") {
+        fn = gemm_packed;
+        span = "gemm_packed";
+    } else if (variant == "blas") {
+#ifdef GEMM_WITH_BLAS
+        fn = gemm_blas;
+        span = "gemm_blas";
+#else
+        throw std::runtime_error("built without GEMM_WITH_BLAS");
+#endif
+    } else {
+        throw std::runtime_error("unknown --variant " + variant);
+    }
+    // The first BLAS call starts its thread pool; keep that out of the timing.
+    if (variant == "blas") {
+        fn(args.m, args.n, args.k, hA.data(), hB.data(), hC.data());
+    }
+    double total_ms = 0.0;
+    for (int iter = 0; iter < args.iters; ++iter) {
+        auto start = std::chrono::steady_clock::now();
+        CHOL_TRACE_BEGIN(t_gemm);
+        fn(args.m, args.n, args.k, hA.data(), hB.data(), hC.data());
+        CHOL_TRACE_END(t_gemm, span);
+        auto stop = std::chrono::steady_clock::now();
+        total_ms += std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+    return total_ms / static_cast<double>(args.iters);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    try {
+        args = parse_args(argc, argv);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Argument error: %s\n", ex.what());
+        return 1;
+    }
+
+    if (!args.trace_path.empty()) {
+        chol_trace_enable();
+    }
+
+    CHOL_TRACE_BEGIN(t_generate);
+    std::vector<double> hA(static_cast<size_t>(args.m) * args.k);
+    std::vector<double> hB(static_cast<size_t>(args.k) * args.n);
+    std::vector<double> hC(static_cast<size_t>(args.m) * args.n);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (double& v : hA) {
+        v = dist(rng);
+    }
+    for (double& v : hB) {
+        v = dist(rng);
+    }
+    CHOL_TRACE_END(t_generate, "generate");
+
+    std::vector<std::string> variants;
+    if (args.variant == "all") {
+        variants = {"naive", "tiled", "packed"};
+#ifdef GEMM_WITH_BLAS
+        variants.push_back("blas");
+#endif
+#ifdef GEMM_WITH_HIP
+        variants.push_back("hip");
+        variants.push_back("rocblas");
+#endif
+    } else {
+        variants = {args.variant};
+    }
+
+    const double flops = 2.0 * args.m * static_cast<double>(args.n) * args.k;
+    double timed_ms = 0.0;
+    for (const std::string& variant : variants) {
+        double avg_ms = 0.0;
+        try {
+            if (variant == "hip" || variant == "rocblas") {
+#ifdef GEMM_WITH_HIP
+                avg_ms = run_hip(args, variant == "rocblas", hA, hB, hC);
+#else
+                throw std::runtime_error("built without GEMM_WITH_HIP");
+#endif
+            } else {
+                avg_ms = run_cpu(args, variant, hA, hB, hC);
+            }
+        } catch (const std::exception& ex) {
+            std::fprintf(stderr, "gemm %s failed: %s\n", variant.c_str(), ex.what());
+            return 1;
+        }
+
+        timed_ms += avg_ms * args.iters;
+        CHOL_TRACE_BEGIN(t_verify);
+        double max_err = check_result(args.m, args.n, args.k, hA.data(), hB.data(), hC.data());
+        CHOL_TRACE_END(t_verify, "verify");
+        if (max_err > 1e-10) {
+            std::fprintf(stderr, "gemm %s verification failed: max_err=%.3e\n", variant.c_str(),
+                         max_err);
+            return 2;
+        }
+        double gflops = avg_ms > 0.0 ? flops / (avg_ms * 1e6) : 0.0;
+        if (args.calibrate) {
+            const size_t elems = static_cast<size_t>(args.stream_mb) * 1024 * 1024 / 24;
+            double gbps = 0.0;
+            try {
+                CHOL_TRACE_SCOPE("stream");
+#ifdef GEMM_WITH_HIP
+                gbps = variant == "rocblas" ? stream_hip(elems, args.iters)
+                                            : stream_cpu(elems, args.iters);
+#else
+                gbps = stream_cpu(elems, args.iters);
+#endif
+            } catch (const std::exception& ex) {
+                std::fprintf(stderr, "stream failed: %s\n", ex.what());
+                return 1;
+            }
+            std::printf(
+                "{\"method\":\"calibrate\",\"variant\":\"%s\",\"m\":%d,\"n\":%d,\"k\":%d,"
+                "\"threads\":%d,\"gemm_gflops\":%.3f,\"stream_gbps\":%.3f}\n",
+                variant.c_str(), args.m, args.n, args.k, omp_get_max_threads(), gflops, gbps);
+            continue;
+        }
+        std::printf(
+            "{\"method\":\"gemm_%s\",\"m\":%d,\"n\":%d,\"k\":%d,\"threads\":%d,\"iters\":%d,"
+            "\"time_ms\":%.6f,\"gflops\":%.3f,\"max_err\":%.3e}\n",
+            variant.c_str(), args.m, args.n, args.k, omp_get_max_threads(), args.iters, avg_ms,
+            gflops, max_err);
+    }
+    // The trace covers every variant, so its summary goes on a line of its own.
+    if (!args.trace_path.empty()) {
+        if (chol_trace_dump(args.trace_path.c_str(), "gemm_bench") != 0) {
+            std::fprintf(stderr, "Failed to write trace %s\n", args.trace_path.c_str());
+        }
+        std::printf("{\"method\":\"trace\"");
+        chol_trace_report(stdout, timed_ms);
+        std::printf("}\n");
+    }
+    return 0;
+}
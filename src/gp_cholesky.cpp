@@ -0,0 +1,334 @@
+#include <omp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dense_cholesky.h"
+#include "trace.h"
+
+// Gaussian-process style workload: log det(A), A^-1 * B and selected diagonal
+// entries of A^-1 for one SPD matrix. The fused path gets log det and L^-1 * [B E_S]
+// out of the factorization sweep itself; the separate path runs potrf, a log-det
+// pass, a solve and a selected-inverse solve one after another. E_S holds the unit
+// vectors of the selected indices, so (A^-1)_ss = ||L^-1 e_s||^2 and the full
+// inverse is never formed. The indices are evenly spaced unless --inv-index lists them.
+//
+// The fused sweep does the E_S forward solves inside the factorization, in their own
+// timed loop at each step; that time is charged to selinv_ms, as the separate path
+// charges its forward solve on E_S to sep_selinv_ms.
+namespace {
+struct Args {
+    int n = 2048;
+    int nb = 128;
+    int nrhs = 1;
+    int ninv = 16;
+    std::vector<int> inv_index;
+    int iters = 3;
+    std::string trace_path;
+};
+
+std::vector<int> parse_index_list(const std::string& text) {
+    std::vector<int> out;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        long v = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || v < 0) {
+            throw std::runtime_error("--inv-index must be a comma-separated list of row indices");
+        }
+        out.push_back(static_cast<int>(v));
+    }
+    return out;
+}
+
+Args parse_args(int argc, char** argv) {
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            args.n = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nb") == 0 && i + 1 < argc) {
+            args.nb = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nrhs") == 0 && i + 1 < argc) {
+            args.nrhs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--inv-entries") == 0 && i + 1 < argc) {
+            args.ninv = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--inv-index") == 0 && i + 1 < argc) {
+            args.inv_index = parse_index_list(argv[++i]);
+        } else if (std::strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            args.iters = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            args.trace_path = argv[++i];
+        }
+    }
+    if (args.n <= 0 || args.nb <= 0 || args.iters <= 0 || args.nrhs < 0) {
+        throw std::runtime_error("--n, --nb and --iters must be positive");
+    }
+    // Explicit indices are sorted so first_row[] stays non-decreasing; otherwise
+    // --inv-entries -1 (or anything >= n) selects the whole diagonal of A^-1.
+    if (!args.inv_index.empty()) {
+        std::sort(args.inv_index.begin(), args.inv_index.end());
+        args.inv_index.erase(std::unique(args.inv_index.begin(), args.inv_index.end()),
+                             args.inv_index.end());
+        if (args.inv_index.back() >= args.n) {
+            throw std::runtime_error("--inv-index entries must be below --n");
+        }
+        args.ninv = static_cast<int>(args.inv_index.size());
+    } else if (args.ninv < 0 || args.ninv > args.n) {
+        args.ninv = args.n;
+    }
+    return args;
+}
+
+struct Timings {
+    double factor_ms = 0.0;
+    double logdet_ms = 0.0;
+    double solve_ms = 0.0;
+    double selinv_ms = 0.0;
+
+    double total() const { return factor_ms + logdet_ms + solve_ms + selinv_ms; }
+};
+
+double elapsed_ms(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Right-hand side layout: nrhs dense columns of B followed by one unit vector per
+// selected index, in increasing index order so first_row[] is non-decreasing.
+void init_rhs(const Args& args, const std::vector<double>& B, const std::vector<int>& selected,
+              std::vector<double>& rhs) {
+    const size_t n = static_cast<size_t>(args.n);
+    std::copy(B.begin(), B.end(), rhs.begin());
+    std::fill(rhs.begin() + B.size(), rhs.end(), 0.0);
+    for (size_t c = 0; c < selected.size(); ++c) {
+        rhs[B.size() + c * n + selected[c]] = 1.0;
+    }
+}
+
+// (A^-1)_ss from the columns Y = L^-1 E_S; rows above s are zero.
+void selected_inverse(int n, const double* y, const std::vector<int>& selected, double* out) {
+#pragma omp parallel for schedule(static)
+    for (size_t c = 0; c < selected.size(); ++c) {
+        const double* col = y + c * static_cast<size_t>(n);
+        double sum = 0.0;
+        for (int r = selected[c]; r < n; ++r) {
+            sum += col[r] * col[r];
+        }
+        out[c] = sum;
+    }
+}
+
+int run_fused(const Args& args, std::vector<double>& L, std::vector<double>& rhs,
+              const std::vector<int>& first_row, const std::vector<int>& selected,
+              double* logdet, std::vector<double>& inv, Timings& t) {
+    const int n = args.n;
+    const int total_rhs = static_cast<int>(first_row.size());
+    double* y_sel = rhs.data() + static_cast<size_t>(args.nrhs) * n;
+
+    auto t0 = std::chrono::steady_clock::now();
+    *logdet = 0.0;
+    double es_ms = 0.0;
+    int info = chol::factor_fused(n, args.nb, L.data(), n, total_rhs, rhs.data(), n,
+                                  first_row.data(), logdet, args.nrhs, &es_ms);
+    if (info != 0) {
+        return info;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    {
+        CHOL_TRACE_SCOPE("backward");
+        chol::backward_solve(n, args.nb, L.data(), n, args.nrhs, rhs.data(), n);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    {
+        CHOL_TRACE_SCOPE("selinv");
+        selected_inverse(n, y_sel, selected, inv.data());
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    t.factor_ms += elapsed_ms(t0, t1) - es_ms;
+    t.solve_ms += elapsed_ms(t1, t2);
+    t.selinv_ms += elapsed_ms(t2, t3) + es_ms;
+    return 0;
+}
+
+int run_separate(const Args& args, std::vector<double>& L, std::vector<double>& rhs,
+                 const std::vector<int>& first_row, const std::vector<int>& selected,
+                 double* logdet, std::vector<double>& inv, Timings& t) {
+    const int n = args.n;
+    const int nsel = static_cast<int>(selected.size());
+    double* y_sel = rhs.data() + static_cast<size_t>(args.nrhs) * n;
+
+    auto t0 = std::chrono::steady_clock::now();
+    int info = chol::factor(n, args.nb, L.data(), n);
+    if (info != 0) {
+        return info;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    {
+        CHOL_TRACE_SCOPE("logdet");
+        double sum = 0.0;
+        for (int i = 0; i < n; ++i) {
+            sum += std::log(L[i + static_cast<size_t>(i) * n]);
+        }
+        *logdet = 2.0 * sum;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    {
+        CHOL_TRACE_SCOPE("solve");
+        chol::forward_solve(n, args.nb, L.data(), n, args.nrhs, rhs.data(), n, nullptr);
+        chol::backward_solve(n, args.nb, L.data(), n, args.nrhs, rhs.data(), n);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    {
+        CHOL_TRACE_SCOPE("selinv");
+        chol::forward_solve(n, args.nb, L.data(), n, nsel, y_sel, n,
+                            first_row.data() + args.nrhs);
+        selected_inverse(n, y_sel, selected, inv.data());
+    }
+    auto t4 = std::chrono::steady_clock::now();
+
+    t.factor_ms += elapsed_ms(t0, t1);
+    t.logdet_ms += elapsed_ms(t1, t2);
+    t.solve_ms += elapsed_ms(t2, t3);
+    t.selinv_ms += elapsed_ms(t3, t4);
+    return 0;
+}
+
+// max_i |A x - b|_i / (|A| |x| + |b|)_i over every solved column.
+double solve_residual(int n, int nrhs, const std::vector<double>& A, const std::vector<double>& B,
+                      const std::vector<double>& X) {
+    double worst = 0.0;
+    for (int c = 0; c < nrhs; ++c) {
+        const double* x = X.data() + static_cast<size_t>(c) * n;
+        const double* b = B.data() + static_cast<size_t>(c) * n;
+#pragma omp parallel for schedule(static) reduction(max : worst)
+        for (int i = 0; i < n; ++i) {
+            double r = -b[i];
+            double scale = std::fabs(b[i]);
+            for (int j = 0; j < n; ++j) {
+                double t = A[i + static_cast<size_t>(j) * n] * x[j];
+                r += t;
+                scale += std::fabs(t);
+            }
+            worst = std::max(worst, std::fabs(r) / (scale > 0.0 ? scale : 1.0));
+        }
+    }
+    return worst;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    try {
+        args = parse_args(argc, argv);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Argument error: %s\n", ex.what());
+        return 1;
+    }
+    const int n = args.n;
+    const size_t elems = static_cast<size_t>(n) * static_cast<size_t>(n);
+    if (!args.trace_path.empty()) {
+        chol_trace_enable();
+    }
+
+    CHOL_TRACE_BEGIN(t_generate);
+    std::vector<double> A(elems);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int row = 0; row < n; ++row) {
+        for (int col = 0; col <= row; ++col) {
+            double val = dist(rng);
+            A[row * static_cast<size_t>(n) + col] = val;
+            A[col * static_cast<size_t>(n) + row] = val;
+        }
+        A[row * static_cast<size_t>(n) + row] += static_cast<double>(n);
+    }
+    std::vector<double> B(static_cast<size_t>(args.nrhs) * n);
+    for (double& v : B) {
+        v = dist(rng);
+    }
+
+    std::vector<int> selected = args.inv_index;
+    if (selected.empty()) {
+        selected.resize(args.ninv);
+        for (int c = 0; c < args.ninv; ++c) {
+            selected[c] = static_cast<int>(static_cast<long long>(c) * n / args.ninv);
+        }
+    }
+    std::vector<int> first_row(args.nrhs, 0);
+    first_row.insert(first_row.end(), selected.begin(), selected.end());
+    CHOL_TRACE_END(t_generate, "generate");
+
+    std::vector<double> L(elems);
+    std::vector<double> rhs(first_row.size() * static_cast<size_t>(n));
+    std::vector<double> inv_fused(args.ninv), inv_separate(args.ninv);
+    std::vector<double> x_fused(B.size());
+    double logdet_fused = 0.0, logdet_separate = 0.0;
+    Timings fused, separate;
+
+    for (int iter = 0; iter < args.iters; ++iter) {
+        L = A;
+        init_rhs(args, B, selected, rhs);
+        CHOL_TRACE_BEGIN(t_fused);
+        int info = run_fused(args, L, rhs, first_row, selected, &logdet_fused, inv_fused, fused);
+        CHOL_TRACE_END(t_fused, "fused");
+        if (info != 0) {
+            std::fprintf(stderr, "fused factorization failed with info=%d\n", info);
+            return 1;
+        }
+        std::copy(rhs.begin(), rhs.begin() + B.size(), x_fused.begin());
+
+        L = A;
+        init_rhs(args, B, selected, rhs);
+        CHOL_TRACE_BEGIN(t_separate);
+        info = run_separate(args, L, rhs, first_row, selected, &logdet_separate, inv_separate,
+                            separate);
+        CHOL_TRACE_END(t_separate, "separate");
+        if (info != 0) {
+            std::fprintf(stderr, "factorization failed with info=%d\n", info);
+            return 1;
+        }
+    }
+
+    double residual = solve_residual(n, args.nrhs, A, B, x_fused);
+    double inv_diff = 0.0;
+    for (int c = 0; c < args.ninv; ++c) {
+        inv_diff = std::max(inv_diff, std::fabs(inv_fused[c] - inv_separate[c]) /
+                                          std::fabs(inv_separate[c]));
+    }
+    double inv_sum = 0.0;
+    for (double v : inv_fused) {
+        inv_sum += v;
+    }
+
+    const double scale = 1.0 / static_cast<double>(args.iters);
+    std::printf(
+        "{\"method\":\"gp_fused\",\"n\":%d,\"nb\":%d,\"nrhs\":%d,\"inv_entries\":%d,"
+        "\"threads\":%d,\"iters\":%d,\"time_ms\":%.6f,\"factor_logdet_forward_ms\":%.6f,"
+        "\"backsolve_ms\":%.6f,\"selinv_ms\":%.6f,\"separate_time_ms\":%.6f,"
+        "\"sep_potrf_ms\":%.6f,\"sep_logdet_ms\":%.6f,\"sep_solve_ms\":%.6f,"
+        "\"sep_selinv_ms\":%.6f,\"logdet\":%.10e,\"logdet_diff\":%.3e,\"residual\":%.3e,"
+        "\"inv_diag_sum\":%.10e,\"inv_diff\":%.3e",
+        n, args.nb, args.nrhs, args.ninv, omp_get_max_threads(), args.iters,
+        fused.total() * scale, fused.factor_ms * scale, fused.solve_ms * scale,
+        fused.selinv_ms * scale, separate.total() * scale, separate.factor_ms * scale,
+        separate.logdet_ms * scale, separate.solve_ms * scale, separate.selinv_ms * scale,
+        logdet_fused, std::fabs(logdet_fused - logdet_separate), residual, inv_sum, inv_diff);
+    if (!args.trace_path.empty()) {
+        if (chol_trace_dump(args.trace_path.c_str(), "gp_cholesky") != 0) {
+            std::fprintf(stderr, "Failed to write trace %s\n", args.trace_path.c_str());
+        }
+        chol_trace_report(stdout, (fused.total() + separate.total()));
+    }
+    std::printf("}\n");
+    return 0;
+}
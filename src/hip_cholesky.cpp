@@ -1,6 +1,7 @@
 #include <hip/hip_runtime.h>
 #include <hipsolver.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
@@ -10,10 +11,14 @@
 #include <string>
 #include <vector>
 
+#include "trace.h"
+
 namespace {
 struct Args {
     int n = 1024;
     int iters = 3;
+    int bandwidth = -1;
+    std::string trace_path;
 };
 
 Args parse_args(int argc, char** argv) {
@@ -23,6 +28,10 @@ Args parse_args(int argc, char** argv) {
             args.n = std::atoi(argv[++i]);
         } else if (std::strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
             args.iters = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--bandwidth") == 0 && i + 1 < argc) {
+            args.bandwidth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            args.trace_path = argv[++i];
         }
     }
     return args;
@@ -45,19 +54,40 @@ int main(int argc, char** argv) {
     Args args = parse_args(argc, argv);
     const int n = args.n;
     const size_t elems = static_cast<size_t>(n) * static_cast<size_t>(n);
+    if (!args.trace_path.empty()) {
+        chol_trace_enable();
+    }
 
-    std::vector<double> hA(elems);
+    CHOL_TRACE_BEGIN(t_generate);
+    std::vector<double> hA(elems, 0.0);
     std::mt19937 rng(1234);
     std::uniform_real_distribution<double> dist(-1.0, 1.0);
-    for (int row = 0; row < n; ++row) {
-        for (int col = 0; col <= row; ++col) {
-            double val = dist(rng);
-            hA[row * n + col] = val;
-            hA[col * n + row] = val;
+    if (args.bandwidth >= 0) {
+        // Same banded SPD sequence as band_cholesky, stored densely.
+        const int b = std::min(args.bandwidth, n - 1);
+        for (int col = 0; col < n; ++col) {
+            for (int row = col; row <= std::min(n - 1, col + b); ++row) {
+                double val = dist(rng);
+                if (row == col) {
+                    val += static_cast<double>(2 * b + 1);
+                }
+                hA[row * n + col] = val;
+                hA[col * n + row] = val;
+            }
+        }
+    } else {
+        for (int row = 0; row < n; ++row) {
+            for (int col = 0; col <= row; ++col) {
+                double val = dist(rng);
+                hA[row * n + col] = val;
+                hA[col * n + row] = val;
+            }
+            hA[row * n + row] += static_cast<double>(n);
         }
-        hA[row * n + row] += static_cast<double>(n);
     }
+    CHOL_TRACE_END(t_generate, "generate");
 
+    CHOL_TRACE_BEGIN(t_setup);
     hipsolverHandle_t handle;
     check_solver(hipsolverCreate(&handle), "hipsolverCreate");
 
@@ -80,24 +110,36 @@ int main(int argc, char** argv) {
     hipEvent_t start, stop;
     check_hip(hipEventCreate(&start), "hipEventCreate start");
     check_hip(hipEventCreate(&stop), "hipEventCreate stop");
+    CHOL_TRACE_END(t_setup, "setup");
 
     double total_ms = 0.0;
     for (int iter = 0; iter < args.iters; ++iter) {
+        CHOL_TRACE_BEGIN(t_h2d);
         check_hip(hipMemcpy(dA, hA.data(), elems * sizeof(double), hipMemcpyHostToDevice),
                   "hipMemcpy H2D");
+        CHOL_TRACE_END(t_h2d, "h2d");
+        CHOL_TRACE_BEGIN(t_potrf);
         check_hip(hipEventRecord(start, stream), "hipEventRecord start");
         check_solver(hipsolverDnDpotrf(handle, HIPSOLVER_FILL_MODE_LOWER, n, dA, n, work, lwork, dInfo),
                      "hipsolverDnDpotrf");
         check_hip(hipEventRecord(stop, stream), "hipEventRecord stop");
         check_hip(hipEventSynchronize(stop), "hipEventSynchronize stop");
+        CHOL_TRACE_END(t_potrf, "potrf");
         float elapsed = 0.0f;
         check_hip(hipEventElapsedTime(&elapsed, start, stop), "hipEventElapsedTime");
         total_ms += static_cast<double>(elapsed);
     }
 
     double avg_ms = total_ms / static_cast<double>(args.iters);
-    std::printf("{\"method\":\"hipsolver\",\"n\":%d,\"iters\":%d,\"time_ms\":%.6f}\n",
+    std::printf("{\"method\":\"hipsolver\",\"n\":%d,\"iters\":%d,\"time_ms\":%.6f",
                 n, args.iters, avg_ms);
+    if (!args.trace_path.empty()) {
+        if (chol_trace_dump(args.trace_path.c_str(), "hipsolver") != 0) {
+            std::fprintf(stderr, "Failed to write trace %s\n", args.trace_path.c_str());
+        }
+        chol_trace_report(stdout, total_ms);
+    }
+    std::printf("}\n");
 
     hipEventDestroy(start);
     hipEventDestroy(stop);
@@ -0,0 +1,255 @@
+#include <omp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dense_cholesky.h"
+#include "trace.h"
+
+// Diagonal-pivoted (rank-revealing) Cholesky of an RBF kernel matrix, A ~= L * L^T
+// with L n x k. Matrix entries come from the kernel on demand, so the low-rank path
+// needs O(n * k) memory and O(n * k^2) time; the residual A - L * L^T is PSD, so its
+// trace bounds both its 2-norm and its Frobenius norm.
+namespace {
+struct Args {
+    int n = 4096;
+    int dim = 3;
+    int max_rank = 512;
+    double tol = 1e-4;
+    double lengthscale = 0.5;
+    double noise = 1e-6;
+    int dense_max = 8192;
+    int nb = 128;
+    int iters = 3;
+    std::string trace_path;
+};
+
+Args parse_args(int argc, char** argv) {
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            args.n = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--dim") == 0 && i + 1 < argc) {
+            args.dim = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-rank") == 0 && i + 1 < argc) {
+            args.max_rank = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tol") == 0 && i + 1 < argc) {
+            args.tol = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--lengthscale") == 0 && i + 1 < argc) {
+            args.lengthscale = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--noise") == 0 && i + 1 < argc) {
+            args.noise = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--dense-max") == 0 && i + 1 < argc) {
+            args.dense_max = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nb") == 0 && i + 1 < argc) {
+            args.nb = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            args.iters = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            args.trace_path = argv[++i];
+        }
+    }
+    if (args.n <= 0 || args.dim <= 0 || args.nb <= 0 || args.iters <= 0) {
+        throw std::runtime_error("--n, --dim, --nb and --iters must be positive");
+    }
+    if (args.max_rank <= 0 || args.max_rank > args.n) {
+        args.max_rank = args.n;
+    }
+    return args;
+}
+
+// k(x, y) = exp(-|x - y|^2 / (2 l^2)), plus noise on the diagonal.
+struct RbfKernel {
+    int n = 0;
+    int dim = 0;
+    double inv_two_l2 = 0.0;
+    double noise = 0.0;
+    std::vector<double> points;
+
+    explicit RbfKernel(const Args& args) : n(args.n), dim(args.dim), noise(args.noise) {
+        inv_two_l2 = 1.0 / (2.0 * args.lengthscale * args.lengthscale);
+        points.resize(static_cast<size_t>(n) * dim);
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (double& v : points) {
+            v = dist(rng);
+        }
+    }
+
+    double operator()(int i, int j) const {
+        const double* x = points.data() + static_cast<size_t>(i) * dim;
+        const double* y = points.data() + static_cast<size_t>(j) * dim;
+        double d2 = 0.0;
+        for (int t = 0; t < dim; ++t) {
+            double d = x[t] - y[t];
+            d2 += d * d;
+        }
+        return std::exp(-d2 * inv_two_l2) + (i == j ? noise : 0.0);
+    }
+};
+
+struct LowRank {
+    int rank = 0;
+    double trace = 0.0;
+    double residual_trace = 0.0;
+    std::vector<double> L;  // n x rank, column-major
+    std::vector<int> pivots;
+};
+
+// Greedy diagonal pivoting: each step takes the largest residual diagonal entry,
+// builds one column of L from a single kernel column, and stops once the residual
+// trace drops below tol * trace(A) or max_rank columns exist.
+LowRank pivoted_cholesky(const RbfKernel& K, int max_rank, double tol) {
+    const int n = K.n;
+    constexpr int CHUNK = 256;
+    LowRank out;
+    std::vector<double> d(n);
+    for (int i = 0; i < n; ++i) {
+        d[i] = K(i, i);
+        out.trace += d[i];
+    }
+    out.L.reserve(static_cast<size_t>(n) * std::min(max_rank, 64));
+    std::vector<double> lpiv;
+    std::vector<char> taken(n, 0);
+
+    double residual = out.trace;
+    while (out.rank < max_rank && residual > tol * out.trace) {
+        CHOL_TRACE_SCOPE("pivot_step");
+        const int m = out.rank;
+        int piv = -1;
+        double best = 0.0;
+        for (int i = 0; i < n; ++i) {
+            if (!taken[i] && d[i] > best) {
+                best = d[i];
+                piv = i;
+            }
+        }
+        if (piv < 0) {
+            break;
+        }
+
+        lpiv.resize(m);
+        for (int p = 0; p < m; ++p) {
+            lpiv[p] = out.L[piv + static_cast<size_t>(p) * n];
+        }
+        out.L.resize(static_cast<size_t>(n) * (m + 1));
+        double* col = out.L.data() + static_cast<size_t>(m) * n;
+        const double inv = 1.0 / std::sqrt(best);
+
+        // col = (A(:, piv) - L(:, 0:m) * L(piv, 0:m)^T) / sqrt(d[piv]), by row chunks.
+#pragma omp parallel for schedule(static)
+        for (int i0 = 0; i0 < n; i0 += CHUNK) {
+            const int ie = std::min(n, i0 + CHUNK);
+            for (int i = i0; i < ie; ++i) {
+                col[i] = K(i, piv);
+            }
+            for (int p = 0; p < m; ++p) {
+                const double* lp = out.L.data() + static_cast<size_t>(p) * n;
+                const double t = lpiv[p];
+                for (int i = i0; i < ie; ++i) {
+                    col[i] -= lp[i] * t;
+                }
+            }
+            for (int i = i0; i < ie; ++i) {
+                col[i] = taken[i] ? 0.0 : col[i] * inv;
+                d[i] = std::max(0.0, d[i] - col[i] * col[i]);
+            }
+        }
+        col[piv] = std::sqrt(best);
+        d[piv] = 0.0;
+        taken[piv] = 1;
+        out.pivots.push_back(piv);
+        out.rank = m + 1;
+
+        residual = 0.0;
+        for (int i = 0; i < n; ++i) {
+            residual += d[i];
+        }
+    }
+    out.residual_trace = residual;
+    return out;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    try {
+        args = parse_args(argc, argv);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "Argument error: %s\n", ex.what());
+        return 1;
+    }
+    const int n = args.n;
+    if (!args.trace_path.empty()) {
+        chol_trace_enable();
+    }
+
+    RbfKernel K(args);
+    LowRank result;
+    double total_ms = 0.0;
+    for (int iter = 0; iter < args.iters; ++iter) {
+        CHOL_TRACE_BEGIN(t_pivoted);
+        auto start = std::chrono::steady_clock::now();
+        result = pivoted_cholesky(K, args.max_rank, args.tol);
+        auto stop = std::chrono::steady_clock::now();
+        CHOL_TRACE_END(t_pivoted, "pivoted");
+        total_ms += std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+
+    // Dense reference: the same matrix materialized and fully factored, when it fits.
+    double dense_ms = -1.0;
+    int dense_info = 0;
+    if (n <= args.dense_max) {
+        const size_t elems = static_cast<size_t>(n) * static_cast<size_t>(n);
+        std::vector<double> A(elems);
+        double dense_total = 0.0;
+        for (int iter = 0; iter < args.iters && dense_info == 0; ++iter) {
+            CHOL_TRACE_BEGIN(t_generate);
+#pragma omp parallel for schedule(static)
+            for (int j = 0; j < n; ++j) {
+                for (int i = j; i < n; ++i) {
+                    A[i + static_cast<size_t>(j) * n] = K(i, j);
+                }
+            }
+            CHOL_TRACE_END(t_generate, "generate");
+            CHOL_TRACE_BEGIN(t_dense);
+            auto start = std::chrono::steady_clock::now();
+            dense_info = chol::factor(n, args.nb, A.data(), n);
+            auto stop = std::chrono::steady_clock::now();
+            CHOL_TRACE_END(t_dense, "dense");
+            dense_total += std::chrono::duration<double, std::milli>(stop - start).count();
+        }
+        if (dense_info == 0) {
+            dense_ms = dense_total / static_cast<double>(args.iters);
+        } else {
+            std::fprintf(stderr, "dense factorization failed with info=%d\n", dense_info);
+        }
+    }
+
+    const double avg_ms = total_ms / static_cast<double>(args.iters);
+    const double factor_kb = static_cast<double>(n) * result.rank * sizeof(double) / 1024.0;
+    const double dense_kb = static_cast<double>(n) * n * sizeof(double) / 1024.0;
+    std::printf(
+        "{\"method\":\"pivoted\",\"n\":%d,\"dim\":%d,\"max_rank\":%d,\"tol\":%.3e,\"rank\":%d,"
+        "\"trace_error\":%.6e,\"threads\":%d,\"iters\":%d,\"time_ms\":%.6f,\"factor_kb\":%.1f,"
+        "\"dense_time_ms\":%.6f,\"dense_kb\":%.1f,\"speedup\":%.3f",
+        n, args.dim, args.max_rank, args.tol, result.rank, result.residual_trace / result.trace,
+        omp_get_max_threads(), args.iters, avg_ms, factor_kb, dense_ms, dense_kb,
+        dense_ms > 0.0 && avg_ms > 0.0 ? dense_ms / avg_ms : -1.0);
+    if (!args.trace_path.empty()) {
+        if (chol_trace_dump(args.trace_path.c_str(), "pivoted_cholesky") != 0) {
+            std::fprintf(stderr, "Failed to write trace %s\n", args.trace_path.c_str());
+        }
+        chol_trace_report(stdout, total_ms);
+    }
+    std::printf("}\n");
+    return 0;
+}
@@ -5,6 +5,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "trace.h"
+
 extern void Cblacs_pinfo(int* mypnum, int* nprocs);
 extern void Cblacs_get(int context, int request, int* value);
 extern void Cblacs_gridinit(int* context, const char* order, int nprow, int npcol);
@@ -19,12 +21,15 @@ extern void descinit_(int* desc, const int* m, const int* n, const int* mb, cons
 extern void pdpotrf_(const char* uplo, const int* n, double* a, const int* ia, const int* ja,
                      const int* desca, int* info);
 
-static void parse_args(int argc, char** argv, int* n, int* nb, int* p, int* q, int* iters) {
+static void parse_args(int argc, char** argv, int* n, int* nb, int* p, int* q, int* iters,
+                       int* bandwidth, const char** trace_path) {
     *n = 1024;
     *nb = 256;
     *p = 1;
     *q = 1;
     *iters = 3;
+    *bandwidth = -1;
+    *trace_path = NULL;
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
             *n = atoi(argv[++i]);
@@ -36,10 +41,55 @@ static void parse_args(int argc, char** argv, int* n, int* nb, int* p, int* q, i
             *q = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
             *iters = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bandwidth") == 0 && i + 1 < argc) {
+            *bandwidth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            *trace_path = argv[++i];
         }
     }
 }
 
+/* Gathers every rank's events on rank 0 (pid = rank) and writes a single trace file. */
+static int write_trace(const char* path, int rank, int size) {
+    char name[32];
+    snprintf(name, sizeof(name), "rank %d", rank);
+    size_t len = 0;
+    char* events = chol_trace_events_json(rank, name, &len);
+    int local_len = events ? (int)len : 0;
+
+    int* lens = NULL;
+    int* displs = NULL;
+    char* all = NULL;
+    int total = 0;
+    if (rank == 0) {
+        lens = (int*)malloc((size_t)size * sizeof(int));
+        displs = (int*)malloc((size_t)size * sizeof(int));
+    }
+    MPI_Gather(&local_len, 1, MPI_INT, lens, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        /* One extra byte per rank for the separating comma. */
+        for (int r = 0; r < size; ++r) {
+            displs[r] = total + r;
+            total += lens[r];
+        }
+        all = (char*)malloc((size_t)total + (size_t)size);
+        for (int r = 1; r < size; ++r) {
+            all[displs[r] - 1] = ',';
+        }
+    }
+    MPI_Gatherv(events, local_len, MPI_CHAR, all, lens, displs, MPI_CHAR, 0, MPI_COMM_WORLD);
+    free(events);
+
+    int status = 0;
+    if (rank == 0) {
+        status = chol_trace_write(path, all, (size_t)total + (size_t)(size - 1));
+        free(all);
+        free(lens);
+        free(displs);
+    }
+    return status;
+}
+
 static int local_to_global(int local_index, int nb, int proc_coord, int nprocs) {
     int block = local_index / nb;
     int offset = local_index % nb;
@@ -49,8 +99,9 @@ static int local_to_global(int local_index, int nb, int proc_coord, int nprocs)
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
 
-    int n = 0, nb = 0, p = 0, q = 0, iters = 0;
-    parse_args(argc, argv, &n, &nb, &p, &q, &iters);
+    int n = 0, nb = 0, p = 0, q = 0, iters = 0, bandwidth = -1;
+    const char* trace_path = NULL;
+    parse_args(argc, argv, &n, &nb, &p, &q, &iters, &bandwidth, &trace_path);
 
     int rank = 0;
     int size = 0;
@@ -64,6 +115,13 @@ int main(int argc, char** argv) {
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
+    if (trace_path) {
+        /* Start every rank's clock at the same barrier so the timelines line up. */
+        MPI_Barrier(MPI_COMM_WORLD);
+        chol_trace_enable();
+    }
+
+    CHOL_TRACE_BEGIN(t_setup);
     int context = 0;
     Cblacs_get(0, 0, &context);
     Cblacs_gridinit(&context, "Row", p, q);
@@ -96,23 +154,41 @@ int main(int argc, char** argv) {
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
+    CHOL_TRACE_END(t_setup, "setup");
+
+    CHOL_TRACE_BEGIN(t_generate);
     for (int j = 0; j < local_cols; ++j) {
         int global_j = local_to_global(j, nb, mycol, npcol);
         for (int i = 0; i < local_rows; ++i) {
             int global_i = local_to_global(i, nb, myrow, nprow);
             double val = (global_i == global_j) ? (double)n : 1e-3;
+            if (bandwidth >= 0) {
+                /* Same band structure as band_cholesky, diagonally dominant. */
+                int dist = abs(global_i - global_j);
+                val = dist > bandwidth ? 0.0 : (dist == 0 ? (double)(2 * bandwidth + 1) : 1e-3);
+            }
             Aorig[j * local_rows + i] = val;
         }
     }
 
+    CHOL_TRACE_END(t_generate, "generate");
+
     double total_time = 0.0;
     for (int iter = 0; iter < iters; ++iter) {
+        CHOL_TRACE_BEGIN(t_copy);
         memcpy(A, Aorig, local_elems * sizeof(double));
+        CHOL_TRACE_END(t_copy, "copy");
+        CHOL_TRACE_BEGIN(t_barrier0);
         MPI_Barrier(MPI_COMM_WORLD);
+        CHOL_TRACE_END(t_barrier0, "barrier");
         double t0 = MPI_Wtime();
         int ia = 1, ja = 1;
+        CHOL_TRACE_BEGIN(t_potrf);
         pdpotrf_("L", &n, A, &ia, &ja, descA, &info);
+        CHOL_TRACE_END(t_potrf, "pdpotrf");
+        CHOL_TRACE_BEGIN(t_barrier1);
         MPI_Barrier(MPI_COMM_WORLD);
+        CHOL_TRACE_END(t_barrier1, "barrier");
         double t1 = MPI_Wtime();
         if (info != 0) {
             if (rank == 0) {
@@ -127,10 +203,22 @@ int main(int argc, char** argv) {
     double max_time = 0.0;
     MPI_Reduce(&avg_time, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
 
+    int trace_status = 0;
+    if (trace_path) {
+        trace_status = write_trace(trace_path, rank, size);
+    }
+
     if (rank == 0) {
         double time_ms = max_time * 1000.0;
-        printf("{\"method\":\"scalapack\",\"n\":%d,\"iters\":%d,\"time_ms\":%.6f}\n",
+        printf("{\"method\":\"scalapack\",\"n\":%d,\"iters\":%d,\"time_ms\":%.6f",
                n, iters, time_ms);
+        if (trace_path) {
+            if (trace_status != 0) {
+                fprintf(stderr, "Failed to write trace %s\n", trace_path);
+            }
+            chol_trace_report(stdout, total_time * 1000.0);
+        }
+        printf("}\n");
     }
 
     free(A);
@@ -0,0 +1,244 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+
+#if CHOL_TRACE
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CHOL_TRACE_RING_SIZE 65536
+
+typedef struct {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+} chol_trace_event;
+
+typedef struct chol_trace_ring {
+    chol_trace_event events[CHOL_TRACE_RING_SIZE];
+    uint64_t count;
+    int tid;
+    struct chol_trace_ring* next;
+} chol_trace_ring;
+
+int chol_trace_on = 0;
+
+static uint64_t epoch_ns = 0;
+static chol_trace_ring* rings = NULL;
+static chol_trace_ring* spare_rings = NULL;
+static int next_tid = 0;
+static pthread_mutex_t rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local chol_trace_ring* local_ring = NULL;
+
+uint64_t chol_trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* malloc + memset rather than calloc, so every page is faulted in here and not on
+ * the first spans a thread records inside a timed region. */
+static chol_trace_ring* alloc_ring(void) {
+    chol_trace_ring* ring = (chol_trace_ring*)malloc(sizeof(chol_trace_ring));
+    if (ring) {
+        memset(ring, 0, sizeof(*ring));
+    }
+    return ring;
+}
+
+/* One ring per OpenMP thread (or per core), plus one for a helper thread. */
+static int expected_threads(void) {
+    const char* env = getenv("OMP_NUM_THREADS");
+    int threads = env ? atoi(env) : 0;
+    if (threads <= 0) {
+        long procs = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = procs > 0 ? (int)procs : 1;
+    }
+    return threads + 1;
+}
+
+void chol_trace_enable(void) {
+    int want = expected_threads();
+    pthread_mutex_lock(&rings_lock);
+    for (int i = 0; i < want; ++i) {
+        chol_trace_ring* ring = alloc_ring();
+        if (!ring) {
+            break;
+        }
+        ring->next = spare_rings;
+        spare_rings = ring;
+    }
+    pthread_mutex_unlock(&rings_lock);
+    epoch_ns = chol_trace_now_ns();
+    chol_trace_on = 1;
+}
+
+/* Hands a thread one of the rings reserved by chol_trace_enable; threads beyond
+ * that reserve allocate their own. */
+static chol_trace_ring* register_ring(void) {
+    pthread_mutex_lock(&rings_lock);
+    chol_trace_ring* ring = spare_rings;
+    if (ring) {
+        spare_rings = ring->next;
+    }
+    pthread_mutex_unlock(&rings_lock);
+    if (!ring) {
+        ring = alloc_ring();
+        if (!ring) {
+            return NULL;
+        }
+    }
+    pthread_mutex_lock(&rings_lock);
+    ring->tid = next_tid++;
+    ring->next = rings;
+    rings = ring;
+    pthread_mutex_unlock(&rings_lock);
+    return ring;
+}
+
+static void ring_push(chol_trace_ring* ring, const char* name, uint64_t start_ns,
+                      uint64_t end_ns) {
+    chol_trace_event* ev = &ring->events[ring->count % CHOL_TRACE_RING_SIZE];
+    ev->name = name;
+    ev->start_ns = start_ns;
+    ev->end_ns = end_ns;
+    ring->count++;
+}
+
+void chol_trace_record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+    if (!local_ring) {
+        local_ring = register_ring();
+        if (!local_ring) {
+            return;
+        }
+    }
+    ring_push(local_ring, name, start_ns, end_ns);
+}
+
+uint64_t chol_trace_event_count(void) {
+    uint64_t total = 0;
+    pthread_mutex_lock(&rings_lock);
+    for (chol_trace_ring* ring = rings; ring; ring = ring->next) {
+        total += ring->count;
+    }
+    pthread_mutex_unlock(&rings_lock);
+    return total;
+}
+
+double chol_trace_span_cost_ns(void) {
+    /* Same work as CHOL_TRACE_BEGIN/END, into a scratch ring so the trace is untouched. */
+    enum { SAMPLES = 100000 };
+    chol_trace_ring* scratch = (chol_trace_ring*)calloc(1, sizeof(chol_trace_ring));
+    if (!scratch) {
+        return -1.0;
+    }
+    uint64_t t0 = chol_trace_now_ns();
+    for (int i = 0; i < SAMPLES; ++i) {
+        uint64_t start = chol_trace_now_ns();
+        ring_push(scratch, "calibrate", start, chol_trace_now_ns());
+    }
+    uint64_t t1 = chol_trace_now_ns();
+    free(scratch);
+    return (double)(t1 - t0) / (double)SAMPLES;
+}
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} chol_trace_buf;
+
+static int buf_printf(chol_trace_buf* buf, const char* fmt, ...) {
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int needed = vsnprintf(buf->data + buf->len, buf->cap - buf->len, fmt, ap);
+        va_end(ap);
+        if (needed < 0) {
+            return -1;
+        }
+        if (buf->len + (size_t)needed < buf->cap) {
+            buf->len += (size_t)needed;
+            return 0;
+        }
+        size_t cap = buf->cap * 2 + (size_t)needed + 1;
+        char* grown = (char*)realloc(buf->data, cap);
+        if (!grown) {
+            return -1;
+        }
+        buf->data = grown;
+        buf->cap = cap;
+    }
+}
+
+char* chol_trace_events_json(int pid, const char* process_name, size_t* len) {
+    chol_trace_buf buf = {NULL, 0, 0};
+    buf.cap = 4096;
+    buf.data = (char*)malloc(buf.cap);
+    if (!buf.data) {
+        *len = 0;
+        return NULL;
+    }
+    buf.data[0] = '\0';
+
+    buf_printf(&buf, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}}",
+               pid, process_name);
+    pthread_mutex_lock(&rings_lock);
+    for (chol_trace_ring* ring = rings; ring; ring = ring->next) {
+        buf_printf(&buf,
+                   ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                   "\"args\":{\"name\":\"thread %d\"}}",
+                   pid, ring->tid, ring->tid);
+        uint64_t first = ring->count > CHOL_TRACE_RING_SIZE ? ring->count - CHOL_TRACE_RING_SIZE : 0;
+        for (uint64_t i = first; i < ring->count; ++i) {
+            const chol_trace_event* ev = &ring->events[i % CHOL_TRACE_RING_SIZE];
+            double ts_us = (double)(int64_t)(ev->start_ns - epoch_ns) / 1000.0;
+            double dur_us = (double)(ev->end_ns - ev->start_ns) / 1000.0;
+            buf_printf(&buf,
+                       ",{\"name\":\"%s\",\"cat\":\"chol\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                       "\"ts\":%.3f,\"dur\":%.3f}",
+                       ev->name, pid, ring->tid, ts_us, dur_us);
+        }
+    }
+    pthread_mutex_unlock(&rings_lock);
+    *len = buf.len;
+    return buf.data;
+}
+
+int chol_trace_write(const char* path, const char* events, size_t len) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        return -1;
+    }
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+    fwrite(events, 1, len, f);
+    fputs("]}\n", f);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+int chol_trace_dump(const char* path, const char* process_name) {
+    size_t len = 0;
+    char* events = chol_trace_events_json(0, process_name, &len);
+    if (!events) {
+        return -1;
+    }
+    int status = chol_trace_write(path, events, len);
+    free(events);
+    return status;
+}
+
+void chol_trace_report(FILE* out, double timed_ms) {
+    uint64_t events = chol_trace_event_count();
+    double span_ns = chol_trace_span_cost_ns();
+    double pct = timed_ms > 0.0 ? ((double)events * span_ns) / (timed_ms * 1e6) * 100.0 : 0.0;
+    fprintf(out, ",\"trace_events\":%llu,\"trace_span_ns\":%.1f,\"trace_overhead_est_pct\":%.4f",
+            (unsigned long long)events, span_ns, pct);
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef CHOL_TRACE_H
+#define CHOL_TRACE_H
+
+/*
+ * Lightweight span tracing for the benchmark drivers, exported as Chrome/Perfetto
+ * trace-event JSON. Each thread records into its own fixed-size ring buffer, so
+ * recording takes no locks; the oldest spans are overwritten when a ring is full.
+ * Build with -DCHOL_TRACE=0 (make TRACE=0) to compile every call out.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef CHOL_TRACE
+#define CHOL_TRACE 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CHOL_TRACE
+
+extern int chol_trace_on;
+
+/*
+ * Starts recording; timestamps in the output are relative to this call. Also reserves
+ * and pre-faults one ring per expected thread (OMP_NUM_THREADS, else the core count),
+ * so first spans inside timed regions do not pay for the allocation.
+ */
+void chol_trace_enable(void);
+uint64_t chol_trace_now_ns(void);
+/* name must outlive the trace (string literals in practice). */
+void chol_trace_record(const char* name, uint64_t start_ns, uint64_t end_ns);
+/* Spans recorded so far, including any that were overwritten. */
+uint64_t chol_trace_event_count(void);
+/* Measured cost of one CHOL_TRACE_BEGIN/END pair, in nanoseconds. */
+double chol_trace_span_cost_ns(void);
+/* Comma-separated trace events for this process; free() the result. */
+char* chol_trace_events_json(int pid, const char* process_name, size_t* len);
+/* Wraps events from chol_trace_events_json (possibly concatenated) into a file. */
+int chol_trace_write(const char* path, const char* events, size_t len);
+/* Single-process shortcut: events_json(0, ...) followed by write. */
+int chol_trace_dump(const char* path, const char* process_name);
+/*
+ * Appends ,"trace_events":..,"trace_span_ns":..,"trace_overhead_est_pct":.. to a JSON
+ * result line. The percentage is an estimate, not a measurement: events times the
+ * per-span cost from a microbenchmark, relative to timed_ms. Compare against a
+ * TRACE=0 build for the real cost.
+ */
+void chol_trace_report(FILE* out, double timed_ms);
+
+#define CHOL_TRACE_BEGIN(var) uint64_t var = chol_trace_on ? chol_trace_now_ns() : 0
+#define CHOL_TRACE_END(var, name)                                 \
+    do {                                                          \
+        if (chol_trace_on) {                                      \
+            chol_trace_record((name), (var), chol_trace_now_ns()); \
+        }                                                         \
+    } while (0)
+
+#else
+
+static inline void chol_trace_enable(void) {}
+static inline uint64_t chol_trace_event_count(void) { return 0; }
+static inline double chol_trace_span_cost_ns(void) { return 0.0; }
+static inline char* chol_trace_events_json(int pid, const char* process_name, size_t* len) {
+    (void)pid;
+    (void)process_name;
+    *len = 0;
+    return NULL;
+}
+static inline int chol_trace_write(const char* path, const char* events, size_t len) {
+    (void)path;
+    (void)events;
+    (void)len;
+    return -1;
+}
+static inline int chol_trace_dump(const char* path, const char* process_name) {
+    (void)path;
+    (void)process_name;
+    return -1;
+}
+static inline void chol_trace_report(FILE* out, double timed_ms) {
+    (void)out;
+    (void)timed_ms;
+}
+
+#define CHOL_TRACE_BEGIN(var) ((void)0)
+#define CHOL_TRACE_END(var, name) ((void)0)
+
+#endif
+
+#ifdef __cplusplus
+}
+
+#if CHOL_TRACE
+namespace chol {
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_(name), start_(chol_trace_on ? chol_trace_now_ns() : 0) {}
+    ~TraceScope() {
+        if (chol_trace_on) {
+            chol_trace_record(name_, start_, chol_trace_now_ns());
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+}  // namespace chol
+
+#define CHOL_TRACE_CONCAT_(a, b) a##b
+#define CHOL_TRACE_CONCAT(a, b) CHOL_TRACE_CONCAT_(a, b)
+#define CHOL_TRACE_SCOPE(name) \
+    chol::TraceScope CHOL_TRACE_CONCAT(chol_trace_scope_, __LINE__)(name)
+#else
+#define CHOL_TRACE_SCOPE(name) ((void)0)
+#endif
+#endif
+
+#endif